@@ -0,0 +1,121 @@
+#pragma once
+#include <array>
+#include "Bitboard.hpp"
+
+
+// Precomputed attack tables. Everything here is built at compile time, so attack
+// queries are table lookups with no heap allocation.
+
+namespace Attacks
+{
+    // Ray directions. The first four increase the square index, so the nearest
+    // blocker on those rays is the lowest set bit; the last four use the highest.
+    enum Direction { SOUTH, EAST, SOUTH_EAST, SOUTH_WEST, NORTH, WEST, NORTH_WEST, NORTH_EAST };
+
+    constexpr int directionRow[8] = { 1, 0, 1, 1, -1, 0, -1, -1 };
+    constexpr int directionCol[8] = { 0, 1, 1, -1, 0, -1, -1, 1 };
+
+    constexpr bool onBoard(int row, int col) { return row >= 0 && row < 8 && col >= 0 && col < 8; }
+
+    template <size_t N>
+    constexpr std::array<Bitboard, 64> leaperTable(const int (&rows)[N], const int (&cols)[N])
+    {
+        std::array<Bitboard, 64> table{};
+        for (int square = 0; square < 64; square++)
+            for (size_t i = 0; i < N; i++)
+            {
+                int r = rowOf(square) + rows[i], c = colOf(square) + cols[i];
+                if (onBoard(r, c))
+                    table[square] |= squareBit(squareOf(r, c));
+            }
+        return table;
+    }
+
+    constexpr int knightRows[8] = { -2, -2, 2, 2, -1, -1, 1, 1 };
+    constexpr int knightCols[8] = { -1, 1, -1, 1, -2, 2, -2, 2 };
+    constexpr int kingRows[8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+    constexpr int kingCols[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+    // White pawns capture towards row 0, black pawns towards row 7.
+    constexpr int whitePawnRows[2] = { -1, -1 };
+    constexpr int blackPawnRows[2] = { 1, 1 };
+    constexpr int pawnCols[2] = { -1, 1 };
+
+    inline constexpr std::array<Bitboard, 64> knight = leaperTable(knightRows, knightCols);
+    inline constexpr std::array<Bitboard, 64> king = leaperTable(kingRows, kingCols);
+    inline constexpr std::array<std::array<Bitboard, 64>, 2> pawn = {
+        leaperTable(whitePawnRows, pawnCols),
+        leaperTable(blackPawnRows, pawnCols)
+    };
+
+    constexpr std::array<std::array<Bitboard, 64>, 8> rayTable()
+    {
+        std::array<std::array<Bitboard, 64>, 8> table{};
+        for (int dir = 0; dir < 8; dir++)
+            for (int square = 0; square < 64; square++)
+            {
+                int r = rowOf(square) + directionRow[dir], c = colOf(square) + directionCol[dir];
+                while (onBoard(r, c))
+                {
+                    table[dir][square] |= squareBit(squareOf(r, c));
+                    r += directionRow[dir];
+                    c += directionCol[dir];
+                }
+            }
+        return table;
+    }
+
+    inline constexpr std::array<std::array<Bitboard, 64>, 8> rays = rayTable();
+
+    using SquarePairTable = std::array<std::array<Bitboard, 64>, 64>;
+
+    // between[a][b]: squares strictly between two aligned squares, empty otherwise.
+    // line[a][b]: the whole rank, file or diagonal through two aligned squares.
+    constexpr SquarePairTable alignmentTable(bool wholeLine)
+    {
+        SquarePairTable table{};
+        for (int from = 0; from < 64; from++)
+            for (int dir = 0; dir < 8; dir++)
+            {
+                int opposite = (dir + 4) % 8;
+                Bitboard ray = rays[dir][from];
+                while (ray)
+                {
+                    int to = popLsb(ray);
+                    table[from][to] = wholeLine
+                        ? rays[dir][from] | rays[opposite][from] | squareBit(from)
+                        : rays[dir][from] & rays[opposite][to];
+                }
+            }
+        return table;
+    }
+
+    inline constexpr SquarePairTable between = alignmentTable(false);
+    inline constexpr SquarePairTable line = alignmentTable(true);
+
+    // Squares attacked along one ray, up to and including the first blocker.
+    inline Bitboard rayAttacks(int dir, int square, Bitboard occupied)
+    {
+        Bitboard attacks = rays[dir][square];
+        Bitboard blockers = attacks & occupied;
+        if (blockers)
+            attacks ^= rays[dir][dir < NORTH ? lsb(blockers) : msb(blockers)];
+        return attacks;
+    }
+
+    inline Bitboard bishopAttacks(int square, Bitboard occupied)
+    {
+        return rayAttacks(SOUTH_EAST, square, occupied) | rayAttacks(SOUTH_WEST, square, occupied) |
+               rayAttacks(NORTH_WEST, square, occupied) | rayAttacks(NORTH_EAST, square, occupied);
+    }
+
+    inline Bitboard rookAttacks(int square, Bitboard occupied)
+    {
+        return rayAttacks(SOUTH, square, occupied) | rayAttacks(EAST, square, occupied) |
+               rayAttacks(NORTH, square, occupied) | rayAttacks(WEST, square, occupied);
+    }
+
+    inline Bitboard queenAttacks(int square, Bitboard occupied)
+    {
+        return bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+
+
+// A bitboard holds one bit per square. Square index = row * 8 + col, matching the
+// layout of the 71-character state string (row 0 is black's back rank).
+using Bitboard = uint64_t;
+
+// Piece indices used to address the piece bitboards.
+enum PieceIndex
+{
+    WHITE_PAWN, WHITE_KNIGHT, WHITE_BISHOP, WHITE_ROOK, WHITE_QUEEN, WHITE_KING,
+    BLACK_PAWN, BLACK_KNIGHT, BLACK_BISHOP, BLACK_ROOK, BLACK_QUEEN, BLACK_KING,
+    NO_PIECE
+};
+
+enum PieceType { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING };
+
+enum Color { WHITE, BLACK };
+
+constexpr int makePiece(int color, int type) { return color * 6 + type; }
+
+constexpr int squareOf(int row, int col) { return row * 8 + col; }
+constexpr int rowOf(int square) { return square >> 3; }
+constexpr int colOf(int square) { return square & 7; }
+constexpr Bitboard squareBit(int square) { return Bitboard(1) << square; }
+
+constexpr int popCount(Bitboard bb) { return std::popcount(bb); }
+constexpr int lsb(Bitboard bb) { return std::countr_zero(bb); }
+constexpr int msb(Bitboard bb) { return 63 - std::countl_zero(bb); }
+
+// Returns the index of the lowest set bit and clears it.
+constexpr int popLsb(Bitboard& bb)
+{
+    int square = lsb(bb);
+    bb &= bb - 1;
+    return square;
+}
+
+constexpr int pieceIndex(char piece)
+{
+    switch (piece)
+    {
+        case 'P': return WHITE_PAWN;
+        case 'N': return WHITE_KNIGHT;
+        case 'B': return WHITE_BISHOP;
+        case 'R': return WHITE_ROOK;
+        case 'Q': return WHITE_QUEEN;
+        case 'K': return WHITE_KING;
+        case 'p': return BLACK_PAWN;
+        case 'n': return BLACK_KNIGHT;
+        case 'b': return BLACK_BISHOP;
+        case 'r': return BLACK_ROOK;
+        case 'q': return BLACK_QUEEN;
+        case 'k': return BLACK_KING;
+        default:  return NO_PIECE;
+    }
+}
+
+constexpr char pieceChar(int index)
+{
+    constexpr char chars[] = "PNBRQKpnbrqk0";
+    return chars[index];
+}
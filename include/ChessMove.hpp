@@ -1,35 +1,75 @@
 #pragma once
+#include <cstdint>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <iostream>
 
 
+// A move packed into 16 bits:
+//   bits  0-5   from square (row * 8 + col)
+//   bits  6-11  to square
+//   bits 12-13  promotion piece (0: Queen, 1: Rook, 2: Knight, 3: Bishop)
+//   bits 14-15  flag (normal, promotion, en passant, castling)
+// The flag is a hint filled in by the move generator; moves built from
+// coordinates are flagged NORMAL, and makeMove infers special moves from the
+// board, so the flag takes no part in equality.
 class ChessMove
 {
-    std::pair<int, int> from;
-    std::pair<int, int> to;
-    int promotion;
+    uint16_t data;
 
 public:
-    ChessMove();
-    ChessMove(int fromRow, int fromCol, int toRow, int toCol, int promotion=0);
-    ChessMove(const ChessMove& other);
-    ChessMove& operator=(const ChessMove& other);
-    ~ChessMove();
+    enum Flag : uint16_t { NORMAL = 0, PROMOTION = 1, EN_PASSANT = 2, CASTLING = 3 };
+
+    constexpr ChessMove() : data(0) {}
+    constexpr ChessMove(int fromRow, int fromCol, int toRow, int toCol, int promotion=0)
+        : data(pack((fromRow & 7) * 8 + (fromCol & 7), (toRow & 7) * 8 + (toCol & 7), NORMAL, promotion)) {}
+
+    static constexpr ChessMove fromSquares(int from, int to, Flag flag = NORMAL, int promotion = 0)
+    {
+        ChessMove move;
+        move.data = pack(from, to, flag, promotion);
+        return move;
+    }
+
+    static constexpr ChessMove fromRaw(uint16_t raw)
+    {
+        ChessMove move;
+        move.data = raw;
+        return move;
+    }
+
+    // Packed accessors
+    constexpr int fromSquare() const { return data & 0x3F; }
+    constexpr int toSquare() const { return (data >> 6) & 0x3F; }
+    constexpr Flag getFlag() const { return static_cast<Flag>(data >> 14); }
+    constexpr uint16_t raw() const { return data; }
 
     // Getters
-    std::pair<int, int> getFrom() const;
-    std::pair<int, int> getTo() const;
-    int getPromotion() const;
+    std::pair<int, int> getFrom() const { return {fromSquare() >> 3, fromSquare() & 7}; }
+    std::pair<int, int> getTo() const { return {toSquare() >> 3, toSquare() & 7}; }
+    constexpr int getPromotion() const { return (data >> 12) & 3; }
 
     // Setters
     void setFrom(std::pair<int, int> from);
     void setTo(std::pair<int, int> to);
     void setPromotion(int promotion);
 
-    bool operator==(const ChessMove& other) const;
-    bool operator!=(const ChessMove& other) const;
+    constexpr bool operator==(const ChessMove& other) const { return (data & 0x3FFF) == (other.data & 0x3FFF); }
+    constexpr bool operator!=(const ChessMove& other) const { return !(*this == other); }
 
     void printMove() const;
 
+    // Writes the 5-character "rcrcp" wire format into buffer, without allocating.
+    void format(char* buffer) const;
     std::string toString() const;
-};
\ No newline at end of file
+
+private:
+    static constexpr uint16_t pack(int from, int to, Flag flag, int promotion)
+    {
+        return static_cast<uint16_t>((from & 0x3F) | (to & 0x3F) << 6 | (promotion & 3) << 12 | flag << 14);
+    }
+};
+
+static_assert(sizeof(ChessMove) == 2, "ChessMove must stay packed into 16 bits");
+static_assert(std::is_trivially_copyable_v<ChessMove>, "ChessMove must be trivially copyable");
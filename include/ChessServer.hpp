@@ -8,6 +8,16 @@ public:
     ChessServer();
 
     void start();
+
+    // Search budget of a /getBestMove request, from the optional query parameters
+    // depth, movetime (ms) and nodes. Every search is bounded in time: movetime
+    // defaults to DEFAULT_MOVETIME_MS and is capped at MAX_MOVETIME_MS. Without any
+    // limit the old fixed depth applies. Throws std::invalid_argument on bad values.
+    static SearchLimits parseLimits(const httplib::Request& req);
+    static constexpr int DEFAULT_DEPTH = 5;
+    static constexpr int DEFAULT_MOVETIME_MS = 2000;
+    static constexpr int MAX_MOVETIME_MS = 10000;
+
 private:
     Engine engine;
 };
\ No newline at end of file
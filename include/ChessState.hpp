@@ -1,7 +1,14 @@
 #pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
+#include "Bitboard.hpp"
 #include "ChessMove.hpp"
+#include "MoveList.hpp"
+#include "NNUE.hpp"
 
 
 class ChessState {
@@ -23,6 +30,7 @@ public:
     void makeMove(const ChessMove& move);
     void unmakeMove(const ChessMove& move);
     std::vector<ChessMove> getLegalMoves();
+    void generateLegalMoves(MoveList& legalMoves);
 
 
     // Game state functions
@@ -32,6 +40,29 @@ public:
     bool isStalemate();
     bool isTerminal();
 
+    // Classifies the node and fills legalMoves in a single move generation, so
+    // callers can reuse the list instead of testing for mate and stalemate apart.
+    enum NodeStatus { NORMAL, IN_CHECK, CHECKMATE, STALEMATE };
+    NodeStatus nodeStatus(MoveList& legalMoves);
+
+    // Perft: counts leaf nodes of the legal move tree (bulk-counted at the last ply)
+    uint64_t perft(int depth);
+
+    // Zobrist hash of the position: maintained incrementally by makeMove/unmakeMove,
+    // or computed from scratch
+    uint64_t getKey() const { return key; }
+    uint64_t computeKey() const;
+    uint64_t getPawnKey() const { return pawnKey; }
+    uint64_t computePawnKey() const;
+
+    // Material and piece-square evaluation, interpolated between midgame and
+    // endgame by the remaining material (centipawns, white's point of view)
+    int psqScore() const;
+
+    // Squares attacked by the knights, bishops, rooks and queens of one side and
+    // not occupied by its own pieces (pseudo-legal, no legality tests)
+    int mobility(Color color) const;
+
     void printBoard() const;
     char getPieceAt(int row, int col) const;
     bool isInCheck(bool byWhite) const;
@@ -45,37 +76,133 @@ public:
     bool blackRookAMoved{}, blackRookBMoved{};
     std::pair<int, int> enPassantSquare{-1, -1};
 
-    // Move history
-    struct MoveRecord 
+    // Bitboards, kept in sync with the mailbox above by makeMove/unmakeMove
+    Bitboard pieces[12]{};
+    Bitboard occupancy[2]{}; // Indexed by Color
+    Bitboard allPieces{};
+
+    // King squares by Color (-1 if absent), tracked by putPiece/removePiece. The
+    // piece bitboards double as per-side piece lists, so nothing scans the board.
+    int kingSquare[2]{-1, -1};
+    void updateKingSquare(int color);
+
+    // Zobrist key (pieces, side to move, castling flags and en passant file), and
+    // the key of the pawns alone for the pawn structure cache
+    uint64_t key{};
+    uint64_t pawnKey{};
+
+    // Material + piece-square sums from white's point of view and the game phase,
+    // kept up to date by putPiece/removePiece
+    int mgScore{}, egScore{};
+    int phase{};
+
+    // NNUE first layer, kept up to date by putPiece/removePiece once a network is
+    // attached (attachNetwork recomputes it from the board). The state shares
+    // ownership of the network, so it stays valid for as long as it is attached.
+    std::shared_ptr<const NNUE::Network> network;
+    NNUE::Accumulator accumulator;
+    void attachNetwork(std::shared_ptr<const NNUE::Network> network);
+
+    // Undo history. Each record holds only what makeMove destroys; the rest is
+    // recovered from the move passed to unmakeMove and the board itself.
+    struct UndoRecord
+    {
+        uint64_t prevKey;
+        char capturedPiece;      // '0' if none; the captured pawn for en passant
+        uint8_t prevCastling;    // Castling flags as a bitmask, in state string order
+        int8_t prevEnPassantFile; // -1 if none
+        uint8_t special;         // CASTLED / EN_PASSANT / PROMOTED
+        enum : uint8_t { CASTLED = 1, EN_PASSANT = 2, PROMOTED = 4 };
+    };
+
+    // Fixed-depth stack of undo records. It belongs to the line being searched, not
+    // to the position, so copying a ChessState starts the copy with an empty history.
+    // Only the last MAX_DEPTH moves can be taken back: a longer game played through
+    // one state overwrites the oldest records, and unmakeMove past them does nothing.
+    class UndoStack
+    {
+    public:
+        static constexpr size_t MAX_DEPTH = 512;  // A power of two
+        static_assert((MAX_DEPTH & (MAX_DEPTH - 1)) == 0);
+
+        UndoStack() = default;
+        UndoStack(const UndoStack&) noexcept {}
+        UndoStack& operator=(const UndoStack&) noexcept { count = 0; return *this; }
+
+        UndoRecord& push()
+        {
+            top = (top + 1) & (MAX_DEPTH - 1);
+            count = std::min(count + 1, MAX_DEPTH);
+            return records[top];
+        }
+        const UndoRecord& pop()
+        {
+            assert(count > 0);
+            const UndoRecord& record = records[top];
+            top = (top - 1) & (MAX_DEPTH - 1);
+            count--;
+            return record;
+        }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+
+    private:
+        UndoRecord records[MAX_DEPTH];
+        size_t top = MAX_DEPTH - 1;  // Index of the last record pushed
+        size_t count = 0;
+    };
+    UndoStack undoStack;
+
+    uint8_t castlingMask() const;
+    void setCastlingMask(uint8_t mask);
+
+    // Legal move generation masks, computed once per position
+    struct MoveGenMasks
     {
-        std::pair<int, int> from, to;
-        char movedPiece, capturedPiece;
-        // Extra data for castling:
-        bool isCastling = false;
-        std::pair<int,int> rookFrom, rookTo;
-        // Extra data for en passant:
-        bool isEnPassant = false;
-        std::pair<int,int> enPassantCapturedPos;
-        bool prevWhiteKingMoved, prevBlackKingMoved;
-        bool prevWhiteRookAMoved, prevWhiteRookBMoved;
-        bool prevBlackRookAMoved, prevBlackRookBMoved;
-        std::pair<int, int> prevEnPassantSquare;
+        int kingSquare;     // -1 if the side to move has no king
+        Bitboard checkers;  // Enemy pieces giving check
+        Bitboard checkMask; // Destinations that resolve a check (all squares if not in check)
+        Bitboard pinned;    // Own pieces pinned to the king
     };
-    std::vector<MoveRecord> moveHistory;
-
-    // Pieces moves
-    void getPawnMoves(int row, int col, std::vector<ChessMove>& legalMoves);
-    void getKnightMoves(int row, int col, std::vector<ChessMove>& legalMoves);
-    void getBishopMoves(int row, int col, std::vector<ChessMove>& legalMoves);
-    void getRookMoves(int row, int col, std::vector<ChessMove>& legalMoves);
-    void getQueenMoves(int row, int col, std::vector<ChessMove>& legalMoves);
-    void getKingMoves(int row, int col, std::vector<ChessMove>& legalMoves);
-
-    // Helper functions
-    bool isInsideBoard(int row, int col) const;
-    bool isOpponentPiece(char piece) const;
-    bool isOwnPiece(char piece) const;
-    bool isLegalMove(const ChessMove& move);
+    MoveGenMasks computeMoveGenMasks() const;
+    Bitboard attackersTo(int square, Bitboard occupied) const;
+
+    // Pieces moves. LEGAL emits only legal moves; CAPTURES (captures, en passant
+    // and promotions) and QUIETS (everything else) emit pseudo-legal moves for
+    // staged generation. The public entry points dispatch once on the side to move;
+    // everything below them is specialized for that color at compile time.
+    enum GenType { LEGAL, CAPTURES, QUIETS };
+    void generateMoves(GenType type, MoveList& moves);
+    void generateMoves(GenType type, MoveGenMasks masks, MoveList& moves);
+    template <Color Us> MoveGenMasks computeMoveGenMasks() const;
+    template <Color Us> void generateMoves(GenType type, MoveGenMasks masks, MoveList& moves);
+    template <Color Us> void getPawnMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves);
+    template <Color Us> void getKnightMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves);
+    template <Color Us> void getBishopMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves);
+    template <Color Us> void getRookMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves);
+    template <Color Us> void getQueenMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves);
+    template <Color Us> void getKingMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves);
+    template <Color Us> void getCastlingMoves(MoveList& moves) const;
+    template <Color Us> Bitboard targetMask(GenType type) const;
+    void addMoves(int from, Bitboard targets, MoveList& moves) const;
+
+    // Attack test for a square, specialized on the attacking color
+    template <Color By> bool isAttackedBy(int square) const;
+    template <Color Us> int mobility() const;
+
+    // Legality of moves from staged generation
+    bool isPseudoLegal(const ChessMove& move) const;
+    bool isLegal(const ChessMove& move, const MoveGenMasks& masks) const;
+    template <Color Us> bool isPseudoLegal(const ChessMove& move) const;
+    template <Color Us> bool isLegal(const ChessMove& move, const MoveGenMasks& masks) const;
+    Bitboard pinMask(int square, const MoveGenMasks& masks) const;
+    template <Color Us> bool isLegalEnPassant(int from, int to, int kingSquare) const;
+
+    // Board update helpers (mailbox + bitboards)
+    void putPiece(char piece, int square);
+    void removePiece(int square);
+    void movePiece(int from, int to);
+    char pieceOn(int square) const;
 
     // King positions
     int getWhiteKingRow() const;
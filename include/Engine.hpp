@@ -1,21 +1,134 @@
 #pragma once
+#include "EvalCache.hpp"
 #include "Heuristic.hpp"
 #include "PositionORM.hpp"
+#include "TranspositionTable.hpp"
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <optional>
+
+
+// Leaf evaluations, and how many of them stopped after the cheap terms
+struct EvalStats
+{
+    uint64_t evaluations = 0;
+    uint64_t lazyExits = 0;
+};
+
+
+// Per-search scratch memory and counters, allocated once before a search starts so
+// that the search itself never touches the heap. Each search thread needs its own.
+struct SearchStack
+{
+    static constexpr int MAX_PLY = 64;
+    MoveList moves[MAX_PLY];
+    uint64_t nodes = 0;       // Positions visited by the last search (this thread)
+    int completedDepth = 0;   // Deepest iteration the last search finished
+    EvalStats evalStats;
+
+    // Limits of the running search, set from its SearchLimits
+    uint64_t nodeLimit = 0;
+    std::chrono::steady_clock::time_point deadline;
+    bool hasDeadline = false;
+    bool stopped = false;
+    const std::atomic<bool>* sharedStop = nullptr;  // Raised when the main thread is done
+};
+
+
+// Budget for one search; zero leaves a limit unset. Iterations deepen until a limit
+// is hit, and the first iteration always completes so there is always a move.
+struct SearchLimits
+{
+    int depth = 0;                          // Capped at SearchStack::MAX_PLY - 1
+    std::chrono::milliseconds movetime{0};
+    uint64_t nodes = 0;
+};
+
+
+// Evaluation used unless heuristics are added at runtime
+using DefaultEvaluation = CompositeHeuristic<Weighted<Heuristic2>>;
 
 
 class Engine
 {
 public:
-    Engine();
+    // The transposition table is allocated once here; PERCHFISH_HASH (MB) overrides
+    // the size given.
+    static constexpr size_t DEFAULT_HASH_MB = 64;
+    explicit Engine(const std::string& dbPath = "chess.db", size_t hashMB = DEFAULT_HASH_MB);
     ~Engine();
+    // Best move for a state string. The position database answers requests whose
+    // depth limit it holds a search at least as deep for; anything else is searched
+    // and stored with the depth it completed.
+    std::string getBestMove(const std::string& state, const SearchLimits& limits);
     std::string getBestMove(const std::string& state, int depth);
 
+    // Iterative deepening alpha-beta search from the given state using preallocated
+    // scratch memory. Returns the best move of the last completed iteration, scored in
+    // centipawns for the side to move (see Score.hpp for mate scores). With several
+    // threads (Lazy SMP) the helpers search the same root through the shared tables
+    // until the calling thread, which alone applies the limits, is done; the deepest
+    // completed iteration of any thread is returned. Searches may run concurrently on
+    // one engine, but only one at a time gets the helpers; the others search alone.
+    std::pair<ChessMove, Score> search(ChessState& state, const SearchLimits& limits, SearchStack& stack);
+    std::pair<ChessMove, Score> search(ChessState& state, int depth, SearchStack& stack);
+
+    // Search threads including the caller; PERCHFISH_THREADS sets the initial count.
+    // Helper scratch memory is allocated here, not per search.
+    void setThreads(int threads);
+    int getThreads() const { return threadCount; }
+
+    // Lazy SMP schedule: whether a thread (0 is the calling one, which searches every
+    // depth) runs the iteration of this depth. Each helper skips its own blocks of
+    // depths so that the threads spread over different depths.
+    static bool searchesDepth(int thread, int depth);
+
+    // Evaluates with the given heuristics (summed, through virtual calls) instead of
+    // DefaultEvaluation. Meant for experiments; clears the evaluation cache.
+    void addHeuristic(std::unique_ptr<Heuristic> heuristic);
+
+    // Lazy evaluation: a leaf whose cheap terms are more than this margin outside the
+    // alpha-beta window skips the expensive ones (see TieredHeuristic).
+    void setLazyMargin(Score margin) { lazyMargin = margin; }
+    static constexpr Score DEFAULT_LAZY_MARGIN = 400;
+
+    // Totals over all searches and threads
+    EvalStats getEvalStats() const;
+
+    // Search results shared by all searches of this engine
+    const TranspositionTable& getTranspositionTable() const { return transpositionTable; }
+
+    // Cache of leaf evaluations, shared by all searches of this engine
+    const EvalCache& getEvalCache() const { return evalCache; }
+    static constexpr size_t EVAL_CACHE_MB = 16;
+
 private:
-    std::pair<ChessMove, float> getBestMove_(ChessState& state, int depth);
-    float alphabeta(ChessState& state, int depth, float alpha, float beta, bool maximizingPlayer);
+    std::pair<ChessMove, Score> getBestMove_(ChessState& state, const SearchLimits& limits, int& completedDepth);
+    std::pair<ChessMove, Score> iterate(ChessState& state, SearchStack& stack, int maxDepth, int thread);
+    std::pair<ChessMove, Score> searchRoot(ChessState& state, SearchStack& stack, int depth);
+    bool shouldStop(SearchStack& stack) const;
+    Score alphabeta(ChessState& state, SearchStack& stack, int ply, int depth, Score alpha, Score beta);
 
+    DefaultEvaluation evaluation;
     std::vector<std::unique_ptr<Heuristic>> heuristics;
+    EvalCache evalCache{EVAL_CACHE_MB};
+    TranspositionTable transpositionTable;
+    Score lazyMargin = DEFAULT_LAZY_MARGIN;
+    EvalStats evalStats;
+    mutable std::mutex statsMutex;
+
+    // Helper thread scratch memory, and the copy of the root each one searches
+    struct Helper
+    {
+        SearchStack stack;
+        std::optional<ChessState> state;
+        std::pair<ChessMove, Score> result;
+    };
+    std::vector<std::unique_ptr<Helper>> helpers;
+    std::mutex helperMutex;  // Held by the search using the helpers
+    std::atomic<int> threadCount{1};
 
     PositionORM positionORM;
-};
\ No newline at end of file
+};
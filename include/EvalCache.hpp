@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include "LocklessTable.hpp"
+#include "Score.hpp"
+#include "ShardedCounter.hpp"
+
+
+// Fixed-size cache of static evaluations keyed by the position's Zobrist key, shared
+// lock-free between searches (see LocklessSlot).
+class EvalCache
+{
+public:
+    explicit EvalCache(size_t sizeMB) : entries(sizeMB) {}
+
+    bool probe(uint64_t key, Score& score) const;
+    void store(uint64_t key, Score score);
+    void clear();
+
+    uint64_t probes() const { return probeCount.load(); }
+    uint64_t hits() const { return hitCount.load(); }
+    double hitRate() const { return probes() ? static_cast<double>(hits()) / probes() : 0.0; }
+
+private:
+    LocklessTable<LocklessSlot> entries;
+    mutable ShardedCounter probeCount, hitCount;
+};
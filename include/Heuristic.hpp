@@ -1,215 +1,178 @@
 #pragma once
+#include <concepts>
+#include <memory>
+#include <tuple>
+#include <utility>
 #include "ChessState.hpp"
+#include "EvalTables.hpp"
+#include "NNUE.hpp"
+#include "PawnTable.hpp"
+#include "PieceSquare.hpp"
+#include "Score.hpp"
 
 
+// Static evaluation in centipawns from white's point of view.
 class Heuristic 
 {
 public:
     Heuristic() = default;
     virtual ~Heuristic() = default;
 
-    virtual float operator()(ChessState& state) const = 0;
-
+    virtual Score operator()(ChessState& state) const = 0;
 };
 
 
-class Heuristic1 : public Heuristic
+class Heuristic1 final : public Heuristic
 {   
 public:
-    float operator()(ChessState& state) const override
+    Score operator()(ChessState& state) const override
     {
-        float score = 0;
-        for(int i = 0; i < 8; i++)
+        // Material values indexed by piece type (pawn, knight, bishop, rook, queen, king)
+        constexpr int values[6] = {100, 300, 300, 500, 900, 0};
+
+        Score score = 0;
+        for (int type = WHITE_PAWN; type <= WHITE_KING; type++)
         {
-            for(int j = 0; j < 8; j++)
-            {
-                switch (state.state[i][j])
-                {
-                    case 'P':
-                        score += 1;
-                        break;
-                    case 'p':
-                        score -= 1;
-                        break;
-                    case 'N':
-                        score += 3;
-                        break;
-                    case 'n':
-                        score -= 3;
-                        break;
-                    case 'B':
-                        score += 3;
-                        break;
-                    case 'b':
-                        score -= 3;
-                        break;
-                    case 'R':
-                        score += 5;
-                        break;
-                    case 'r':
-                        score -= 5;
-                        break;
-                    case 'Q':
-                        score += 9;
-                        break;
-                    case 'q':
-                        score -= 9;
-                        break;
-                    case 'K':
-                        break;
-                    case 'k':
-                        break;
-                    default:
-                        break;
-                }
-                
-            }
+            score += values[type] * (popCount(state.pieces[type]) - popCount(state.pieces[type + BLACK_PAWN]));
         }
         return score;
     }
 };
 
 
-class Heuristic2 : public Heuristic {
+class Heuristic2 final : public Heuristic {
 public:
-    float operator()(ChessState& state) const override {
-        float score = 0.0f;
-        
-        // Piece values (scaled up for integer arithmetic)
-        constexpr int pawnValue   = 100;
-        constexpr int knightValue = 320;
-        constexpr int bishopValue = 330;
-        constexpr int rookValue   = 500;
-        constexpr int queenValue  = 900;
-        // King is not assigned a material value here (handled separately by king safety)
-        
-        // Piece-square tables for White (for Black, we mirror vertically)
-        static const int pawnTable[8][8] = {
-            {  0,   0,   0,   0,   0,   0,   0,   0},
-            { 50,  50,  50,  50,  50,  50,  50,  50},
-            { 10,  10,  20,  30,  30,  20,  10,  10},
-            {  5,   5,  10,  25,  25,  10,   5,   5},
-            {  0,   0,   0,  20,  20,   0,   0,   0},
-            {  5,  -5, -10,   0,   0, -10,  -5,   5},
-            {  5,  10,  10, -20, -20,  10,  10,   5},
-            {  0,   0,   0,   0,   0,   0,   0,   0}
-        };
-
-        static const int knightTable[8][8] = {
-            {-50, -40, -30, -30, -30, -30, -40, -50},
-            {-40, -20,   0,   0,   0,   0, -20, -40},
-            {-30,   0,  10,  15,  15,  10,   0, -30},
-            {-30,   5,  15,  20,  20,  15,   5, -30},
-            {-30,   0,  15,  20,  20,  15,   0, -30},
-            {-30,   5,  10,  15,  15,  10,   5, -30},
-            {-40, -20,   0,   5,   5,   0, -20, -40},
-            {-50, -40, -30, -30, -30, -30, -40, -50}
-        };
-
-        static const int bishopTable[8][8] = {
-            {-20, -10, -10, -10, -10, -10, -10, -20},
-            {-10,   0,   0,   0,   0,   0,   0, -10},
-            {-10,   0,   5,  10,  10,   5,   0, -10},
-            {-10,   5,   5,  10,  10,   5,   5, -10},
-            {-10,   0,  10,  10,  10,  10,   0, -10},
-            {-10,  10,  10,  10,  10,  10,  10, -10},
-            {-10,   5,   0,   0,   0,   0,   5, -10},
-            {-20, -10, -10, -10, -10, -10, -10, -20}
-        };
-
-        static const int rookTable[8][8] = {
-            {  0,   0,   0,   0,   0,   0,   0,   0},
-            {  5,  10,  10,  10,  10,  10,  10,   5},
-            { -5,   0,   0,   0,   0,   0,   0,  -5},
-            { -5,   0,   0,   0,   0,   0,   0,  -5},
-            { -5,   0,   0,   0,   0,   0,   0,  -5},
-            { -5,   0,   0,   0,   0,   0,   0,  -5},
-            { -5,   0,   0,   0,   0,   0,   0,  -5},
-            {  0,   0,   0,   5,   5,   0,   0,   0}
-        };
-
-        static const int queenTable[8][8] = {
-            {-20, -10, -10,  -5,  -5, -10, -10, -20},
-            {-10,   0,   0,   0,   0,   0,   0, -10},
-            {-10,   0,   5,   5,   5,   5,   0, -10},
-            { -5,   0,   5,   5,   5,   5,   0,  -5},
-            {  0,   0,   5,   5,   5,   5,   0,  -5},
-            {-10,   5,   5,   5,   5,   5,   0, -10},
-            {-10,   0,   5,   0,   0,   0,   0, -10},
-            {-20, -10, -10,  -5,  -5, -10, -10, -20}
-        };
-
-        static const int kingTable[8][8] = {
-            {-30, -40, -40, -50, -50, -40, -40, -30},
-            {-30, -40, -40, -50, -50, -40, -40, -30},
-            {-30, -40, -40, -50, -50, -40, -40, -30},
-            {-30, -40, -40, -50, -50, -40, -40, -30},
-            {-20, -30, -30, -40, -40, -30, -30, -20},
-            {-10, -20, -20, -20, -20, -20, -20, -10},
-            { 20,  20,   0,   0,   0,   0,  20,  20},
-            { 20,  30,  10,   0,   0,  10,  30,  20}
-        };
-
-        // Loop over board squares
-        for (int i = 0; i < 8; ++i) {
-            for (int j = 0; j < 8; ++j) {
-                char piece = state.state[i][j];
-                switch(piece) {
-                    case 'P':
-                        score += pawnValue + pawnTable[i][j];
-                        break;
-                    case 'p':
-                        // Mirror the table for black pieces
-                        score -= pawnValue + pawnTable[7 - i][j];
-                        break;
-                    case 'N':
-                        score += knightValue + knightTable[i][j];
-                        break;
-                    case 'n':
-                        score -= knightValue + knightTable[7 - i][j];
-                        break;
-                    case 'B':
-                        score += bishopValue + bishopTable[i][j];
-                        break;
-                    case 'b':
-                        score -= bishopValue + bishopTable[7 - i][j];
-                        break;
-                    case 'R':
-                        score += rookValue + rookTable[i][j];
-                        break;
-                    case 'r':
-                        score -= rookValue + rookTable[7 - i][j];
-                        break;
-                    case 'Q':
-                        score += queenValue + queenTable[i][j];
-                        break;
-                    case 'q':
-                        score -= queenValue + queenTable[7 - i][j];
-                        break;
-                    case 'K':
-                        // For king, we only add positional bonus (material is infinite)
-                        score += kingTable[i][j];
-                        break;
-                    case 'k':
-                        score -= kingTable[7 - i][j];
-                        break;
-                    default:
-                        break;
-                }
-            }
-        }
+    Score operator()(ChessState& state) const override {
+        return cheap(state) + expensive(state);
+    }
 
-        // Mobility bonus: Evaluate the difference in legal moves
-        // (Assumes state.getLegalMoves() returns moves for the current side.)
-        std::vector<ChessMove> currentMoves = state.getLegalMoves();
-        // Create a copy of the state with the turn switched to get opponent moves.
-        ChessState opponentState = state;
-        opponentState.whiteToMove = !state.whiteToMove;
-        std::vector<ChessMove> opponentMoves = opponentState.getLegalMoves();
+    // Terms that cost next to nothing: read from incremental sums and caches
+    Score cheap(ChessState& state) const {
+        // Material and piece-square tables, maintained incrementally by the state
+        Score score = state.psqScore();
 
-        // Weight mobility difference by a factor (e.g., 10 points per move)
-        score += 10 * (static_cast<int>(currentMoves.size()) - static_cast<int>(opponentMoves.size()));
+        // Pawn structure, cached by pawn key in the thread's pawn table
+        const PawnTable::Entry& pawns = PawnTable::forThread().probe(state);
+        score += PieceSquare::interpolate({pawns.mg, pawns.eg, state.phase});
 
         return score;
     }
+
+    // Terms that generate attacks for both sides
+    Score expensive(ChessState& state) const {
+        // Mobility bonus: difference in squares attacked by each side's pieces,
+        // from white's point of view like the rest of the score
+        return EvalTables::mobilityWeight * (state.mobility(WHITE) - state.mobility(BLACK));
+    }
+};
+
+
+// Neural network evaluation. The state's accumulator is attached to the network on
+// first use and then follows makeMove/unmakeMove incrementally.
+class NNUEHeuristic final : public Heuristic
+{
+public:
+    explicit NNUEHeuristic(std::shared_ptr<const NNUE::Network> network) : network(std::move(network)) {}
+
+    Score operator()(ChessState& state) const override
+    {
+        if (state.network != network)
+            state.attachNetwork(network);
+        // The network scores for the side to move; heuristics score for white.
+        Score score = network->evaluate(state.accumulator, state.whiteToMove);
+        return state.whiteToMove ? score : -score;
+    }
+
+private:
+    std::shared_ptr<const NNUE::Network> network;
+};
+
+
+// A heuristic split into cheap and expensive terms, so that a lazy evaluation can
+// stop after the cheap ones. The full score is cheap() + expensive().
+template <typename H>
+concept TieredHeuristic = requires(const H& heuristic, ChessState& state) {
+    { heuristic.cheap(state) } -> std::convertible_to<Score>;
+    { heuristic.expensive(state) } -> std::convertible_to<Score>;
+};
+
+
+// A heuristic with a compile-time weight, for use in CompositeHeuristic.
+template <typename H, int Weight = 1>
+struct Weighted
+{
+    using Type = H;
+    static constexpr int weight = Weight;
+};
+
+// Weighted sum of heuristics fixed at compile time. The terms are concrete (final)
+// types called directly, so the compiler can inline and fuse them instead of making
+// one virtual call per heuristic. It is also a Heuristic itself, so it can be used
+// on the runtime-pluggable path too.
+template <typename... Terms>
+class CompositeHeuristic final : public Heuristic
+{
+public:
+    CompositeHeuristic() = default;
+    explicit CompositeHeuristic(typename Terms::Type... terms) : heuristics(std::move(terms)...) {}
+
+    Score evaluate(ChessState& state) const
+    {
+        return evaluate(state, std::index_sequence_for<Terms...>());
+    }
+
+    Score operator()(ChessState& state) const override
+    {
+        return evaluate(state);
+    }
+
+    // Tiers of the sum: terms that are not tiered count entirely as cheap.
+    Score cheap(ChessState& state) const
+    {
+        return cheap(state, std::index_sequence_for<Terms...>());
+    }
+
+    Score expensive(ChessState& state) const
+    {
+        return expensive(state, std::index_sequence_for<Terms...>());
+    }
+
+private:
+    template <size_t... I>
+    Score evaluate(ChessState& state, std::index_sequence<I...>) const
+    {
+        return (Score(0) + ... + (Terms::weight * std::get<I>(heuristics)(state)));
+    }
+
+    template <size_t... I>
+    Score cheap(ChessState& state, std::index_sequence<I...>) const
+    {
+        return (Score(0) + ... + (Terms::weight * cheapPart(std::get<I>(heuristics), state)));
+    }
+
+    template <size_t... I>
+    Score expensive(ChessState& state, std::index_sequence<I...>) const
+    {
+        return (Score(0) + ... + (Terms::weight * expensivePart(std::get<I>(heuristics), state)));
+    }
+
+    template <typename H>
+    static Score cheapPart(const H& heuristic, ChessState& state)
+    {
+        if constexpr (TieredHeuristic<H>)
+            return heuristic.cheap(state);
+        else
+            return heuristic(state);
+    }
+
+    template <typename H>
+    static Score expensivePart(const H& heuristic, ChessState& state)
+    {
+        if constexpr (TieredHeuristic<H>)
+            return heuristic.expensive(state);
+        else
+            return 0;
+    }
+
+    std::tuple<typename Terms::Type...> heuristics;
 };
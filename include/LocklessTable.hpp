@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+
+// Slot of a hash table shared lock-free between threads. The data is stored next to
+// key ^ data, so a torn write from a concurrent store fails validation instead of
+// returning another position's data. Zero data marks an empty slot: it never
+// validates, so tables keep their written data nonzero.
+struct LocklessSlot
+{
+    std::atomic<uint64_t> check{0};
+    std::atomic<uint64_t> data{0};
+
+    // The data stored for this key, if the slot holds it
+    bool read(uint64_t key, uint64_t& value) const
+    {
+        value = data.load(std::memory_order_relaxed);
+        uint64_t stored = check.load(std::memory_order_relaxed);
+        return value != 0 && (stored ^ value) == key;
+    }
+
+    void write(uint64_t key, uint64_t value)
+    {
+        check.store(key ^ value, std::memory_order_relaxed);
+        data.store(value, std::memory_order_relaxed);
+    }
+
+    // Whatever the slot holds, without validation
+    uint64_t peek() const { return data.load(std::memory_order_relaxed); }
+
+    void clear() { write(0, 0); }
+};
+
+
+// Fixed array of table entries indexed by the low bits of the key. The size is
+// rounded down to a power of two so the index is a mask.
+template <typename T>
+class LocklessTable
+{
+public:
+    explicit LocklessTable(size_t sizeMB)
+    {
+        size_t count = std::max<size_t>(1, sizeMB * 1024 * 1024 / sizeof(T));
+        count = size_t(1) << (63 - std::countl_zero(static_cast<uint64_t>(count)));
+        entries = std::make_unique<T[]>(count);
+        mask = count - 1;
+    }
+
+    T& operator[](uint64_t key) { return entries[key & mask]; }
+    const T& operator[](uint64_t key) const { return entries[key & mask]; }
+    size_t size() const { return mask + 1; }
+
+private:
+    std::unique_ptr<T[]> entries;
+    size_t mask;
+};
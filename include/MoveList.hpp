@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include "ChessMove.hpp"
+
+
+// Fixed-capacity list of moves that lives on the stack (or inside a preallocated
+// search stack), so generating moves never touches the heap. No chess position
+// has more than 218 legal moves.
+class MoveList
+{
+public:
+    static constexpr size_t MAX_MOVES = 256;
+
+    void push_back(const ChessMove& move) { moves[count++] = move; }
+    void clear() { count = 0; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    ChessMove& operator[](size_t index) { return moves[index]; }
+    const ChessMove& operator[](size_t index) const { return moves[index]; }
+
+    ChessMove* begin() { return moves; }
+    ChessMove* end() { return moves + count; }
+    const ChessMove* begin() const { return moves; }
+    const ChessMove* end() const { return moves + count; }
+
+private:
+    ChessMove moves[MAX_MOVES];
+    size_t count = 0;
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include "ChessState.hpp"
+
+
+// Hands out the moves of a position lazily, in stages: the hash move, captures
+// (ordered by MVV-LVA), then quiet moves. Stages are generated pseudo-legally and
+// each move is checked for legality only when it is handed out, so a node that
+// cuts off early never generates or tests the moves it does not search.
+class MovePicker
+{
+public:
+    // 'moves' is scratch storage owned by the caller (one list per ply).
+    MovePicker(ChessState& state, MoveList& moves, ChessMove hashMove = ChessMove());
+
+    // Stores the next legal move in 'move'; returns false when none are left.
+    bool next(ChessMove& move);
+
+private:
+    enum Stage { HASH_MOVE, GENERATE_CAPTURES, CAPTURES, GENERATE_QUIETS, QUIETS, DONE };
+
+    void scoreCaptures();
+    void selectBest();
+
+    ChessState& state;
+    MoveList& moves;
+    ChessState::MoveGenMasks masks;
+    ChessMove hashMove;
+    Stage stage;
+    size_t index = 0;
+    int scores[MoveList::MAX_MOVES];
+};
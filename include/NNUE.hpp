@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "Bitboard.hpp"
+
+
+// Efficiently updatable neural network evaluation.
+//
+// Architecture: 768 inputs (PieceIndex * 64 + square) -> HIDDEN int16 neurons,
+// evaluated from both sides' perspectives -> clipped ReLU -> one int8-weighted
+// output. The first layer (the accumulator) lives in ChessState and is updated by
+// putPiece/removePiece, so a move costs a few vector additions instead of a full
+// recomputation. Inference uses AVX2 when the build enables it (PERCHFISH_AVX2)
+// and a scalar loop otherwise; both give identical results.
+namespace NNUE
+{
+    constexpr int INPUTS = 768;
+    constexpr int HIDDEN = 256;
+
+    // Quantization: hidden activations are clipped to [0, QA], output weights are
+    // scaled by QB, and the raw output is mapped to centipawns by SCALE.
+    constexpr int QA = 255;
+    constexpr int QB = 64;
+    constexpr int SCALE = 400;
+
+    // Feature index of a piece on a square, seen from one side. Black's view swaps
+    // the piece colors and mirrors the board vertically.
+    constexpr int featureIndex(int perspective, int piece, int square)
+    {
+        return perspective == 0 ? piece * 64 + square : ((piece + 6) % 12) * 64 + (square ^ 56);
+    }
+
+    // First-layer sums for the white (0) and black (1) perspectives.
+    struct alignas(32) Accumulator
+    {
+        int16_t values[2][HIDDEN];
+    };
+
+    class Network
+    {
+    public:
+        // Loads a network file:
+        //   char[4]  magic "PFNN"
+        //   uint32   version (1)
+        //   uint32   hidden size (must equal HIDDEN)
+        //   int16    feature weights [INPUTS][HIDDEN]
+        //   int16    feature biases  [HIDDEN]
+        //   int8     output weights  [2 * HIDDEN] (side to move first)
+        //   int32    output bias
+        // all little-endian. Returns false if the file is missing or malformed.
+        bool load(const std::string& path);
+
+        // Accumulator maintenance
+        void refresh(Accumulator& accumulator, const Bitboard (&pieces)[12]) const;
+        void addPiece(Accumulator& accumulator, int piece, int square) const;
+        void removePiece(Accumulator& accumulator, int piece, int square) const;
+
+        // Centipawns from the point of view of the side to move.
+        int evaluate(const Accumulator& accumulator, bool whiteToMove) const;
+
+        alignas(32) int16_t featureWeights[INPUTS][HIDDEN];
+        alignas(32) int16_t featureBiases[HIDDEN];
+        alignas(32) int16_t outputWeights[2 * HIDDEN]; // Widened from int8 on load
+        int32_t outputBias;
+    };
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include "ChessState.hpp"
+#include "LocklessTable.hpp"
+
+
+// Hash table of perft subtree counts, shared lock-free between threads (see
+// LocklessSlot). Each entry holds the count with the depth in its low byte.
+class PerftTable
+{
+public:
+    explicit PerftTable(size_t sizeMB) : entries(sizeMB) {}
+
+    bool probe(uint64_t key, int depth, uint64_t& nodes) const;
+    void store(uint64_t key, int depth, uint64_t nodes);
+
+private:
+    LocklessTable<LocklessSlot> entries;
+};
+
+
+struct PerftOptions
+{
+    int threads = 1;      // Root moves are split across this many threads
+    size_t hashMB = 0;    // Transposition table size, 0 disables hashing
+    bool divide = false;  // Report the node count below every root move
+};
+
+struct PerftResult
+{
+    uint64_t nodes = 0;
+    std::vector<std::pair<ChessMove, uint64_t>> divide;
+    double seconds = 0.0;
+
+    double nodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+};
+
+PerftResult runPerft(const ChessState& state, int depth, const PerftOptions& options = {});
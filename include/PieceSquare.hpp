@@ -0,0 +1,54 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include "Bitboard.hpp"
+#include "EvalTables.hpp"
+
+
+// Material + piece-square evaluation built on EvalTables. ChessState keeps the sums
+// incrementally; evaluate() computes them from scratch over the 64-character board,
+// vectorized with AVX2 when the build enables it (PERCHFISH_AVX2).
+namespace PieceSquare
+{
+    // Material and piece-square terms combined per PieceIndex (NO_PIECE reads zero)
+    // and square, signed from white's point of view.
+    struct Table
+    {
+        int32_t mg[13][64];
+        int32_t eg[13][64];
+    };
+
+    constexpr Table makeTable()
+    {
+        Table table{};
+        for (int type = PAWN; type <= KING; type++)
+            for (int square = 0; square < 64; square++)
+            {
+                table.mg[makePiece(WHITE, type)][square] = EvalTables::mgValue[type] + EvalTables::mgTable[type][square];
+                table.eg[makePiece(WHITE, type)][square] = EvalTables::egValue[type] + EvalTables::egTable[type][square];
+                table.mg[makePiece(BLACK, type)][square] = -(EvalTables::mgValue[type] + EvalTables::mgTable[type][square ^ 56]);
+                table.eg[makePiece(BLACK, type)][square] = -(EvalTables::egValue[type] + EvalTables::egTable[type][square ^ 56]);
+            }
+        return table;
+    }
+
+    inline constexpr Table table = makeTable();
+
+    struct Scores
+    {
+        int mg, eg, phase;
+    };
+
+    // Midgame/endgame interpolation by phase. Promotions can push the phase past a
+    // full set of pieces.
+    constexpr int interpolate(const Scores& scores)
+    {
+        int mgPhase = std::min(scores.phase, EvalTables::MAX_PHASE);
+        return (scores.mg * mgPhase + scores.eg * (EvalTables::MAX_PHASE - mgPhase)) / EvalTables::MAX_PHASE;
+    }
+
+    // Sums over a 64-character board (state string order). evaluateScalar is the
+    // portable reference; evaluate uses SIMD when available and matches it exactly.
+    Scores evaluate(const char* board);
+    Scores evaluateScalar(const char* board);
+}
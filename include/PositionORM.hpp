@@ -1,11 +1,13 @@
 #pragma once
 #include <string>
 #include <sqlite3.h>
+#include "Score.hpp"
 
 struct Position {
     std::string fen;       // 71-character board position string
     std::string best_move; // 5-character best move string
-    float score;           // Score as a float
+    Score score;           // Centipawns for the side to move
+    int depth = 0;         // Depth the move was searched to, 0 if unknown
 };
 
 class PositionORM {
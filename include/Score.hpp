@@ -0,0 +1,27 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+
+// Evaluation and search scores in centipawns. Mate scores encode the distance from
+// the root: a side mated at ply n scores matedIn(n) = -(SCORE_MATE - n), so the
+// winner prefers the shortest mate and the loser the longest. All scores fit in 16
+// bits, so hash entries can store them packed.
+using Score = int32_t;
+
+constexpr Score SCORE_DRAW = 0;
+constexpr Score SCORE_MATE = 32000;
+constexpr Score SCORE_INFINITE = 32001;
+
+// Mates are found within this many plies; anything past SCORE_MATE_BOUND is a mate.
+constexpr int MAX_MATE_PLY = 256;
+constexpr Score SCORE_MATE_BOUND = SCORE_MATE - MAX_MATE_PLY;
+
+static_assert(SCORE_INFINITE <= INT16_MAX, "scores must fit in 16 bits");
+
+constexpr Score mateIn(int ply) { return SCORE_MATE - ply; }
+constexpr Score matedIn(int ply) { return -SCORE_MATE + ply; }
+constexpr bool isMateScore(Score score) { return score > SCORE_MATE_BOUND || score < -SCORE_MATE_BOUND; }
+
+// Keeps a static evaluation out of the mate range.
+constexpr Score clampEval(Score score) { return std::clamp(score, -SCORE_MATE_BOUND, SCORE_MATE_BOUND); }
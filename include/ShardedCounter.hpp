@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+
+// Event counter for tables shared by search threads. A single atomic would be
+// incremented by every thread on every node; instead each thread counts into its
+// own cache line and reads sum the shards.
+class ShardedCounter
+{
+public:
+    void add(uint64_t count = 1) { shards[shardIndex()].value.fetch_add(count, std::memory_order_relaxed); }
+
+    uint64_t load() const
+    {
+        uint64_t total = 0;
+        for (const Shard& shard : shards)
+            total += shard.value.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    void reset()
+    {
+        for (Shard& shard : shards)
+            shard.value.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int SHARDS = 16;
+
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> value{0};
+    };
+
+    // Threads are assigned shards round-robin on first use.
+    static int shardIndex()
+    {
+        static std::atomic<int> nextIndex{0};
+        thread_local int index = nextIndex.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+        return index;
+    }
+
+    Shard shards[SHARDS];
+};
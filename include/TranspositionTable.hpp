@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include "ChessMove.hpp"
+#include "LocklessTable.hpp"
+#include "Score.hpp"
+#include "ShardedCounter.hpp"
+
+
+// Search results keyed by the position's Zobrist key, shared lock-free between
+// search threads (see LocklessSlot). Each bucket holds a depth-preferred slot,
+// replaced only by a search at least as deep (or of the same position), and an
+// always-replace slot that takes everything else.
+class TranspositionTable
+{
+public:
+    // What the stored score says about the true score of the position
+    enum Bound : uint8_t { NO_BOUND, UPPER_BOUND, LOWER_BOUND, EXACT };
+
+    struct Entry
+    {
+        ChessMove move;
+        Score score = 0;
+        int depth = 0;
+        Bound bound = NO_BOUND;
+    };
+
+    // The size is rounded down to a power-of-two number of buckets.
+    explicit TranspositionTable(size_t sizeMB) : buckets(sizeMB) {}
+
+    bool probe(uint64_t key, Entry& entry) const;
+    void store(uint64_t key, const Entry& entry);
+    void clear();
+
+    // Called by the search when a probed entry ends the node without searching it.
+    void recordCutoff() { cutoffCount.add(); }
+
+    // Mate scores count plies from the root, but an entry may be reached at another
+    // ply: they are stored relative to the node and converted back on retrieval.
+    static Score toStored(Score score, int ply);
+    static Score fromStored(Score score, int ply);
+
+    size_t bucketCount() const { return buckets.size(); }
+    uint64_t probes() const { return probeCount.load(); }
+    uint64_t hits() const { return hitCount.load(); }
+    uint64_t cutoffs() const { return cutoffCount.load(); }
+    // Stores that evicted a different position
+    uint64_t collisions() const { return collisionCount.load(); }
+
+private:
+    struct alignas(32) Bucket
+    {
+        LocklessSlot depthPreferred;
+        LocklessSlot alwaysReplace;
+    };
+
+    LocklessTable<Bucket> buckets;
+
+    // Statistics, which const probes update too
+    mutable ShardedCounter probeCount, hitCount, cutoffCount, collisionCount;
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ChessState.hpp"
+
+
+// Texel tuning of the Heuristic2 weights in EvalTables: the evaluation is linear in
+// its weights, so each labelled position is reduced once to the features it counts
+// and the weights are fitted to the game results by minimizing the logistic error
+// sum((result - sigmoid(eval))^2).
+namespace Tuner
+{
+    // Parameter vector layout, following EvalTables
+    constexpr int MG_VALUE = 0;                  // [PieceType]
+    constexpr int EG_VALUE = MG_VALUE + 6;       // [PieceType]
+    constexpr int MG_TABLE = EG_VALUE + 6;       // [PieceType][square]
+    constexpr int EG_TABLE = MG_TABLE + 6 * 64;  // [PieceType][square]
+    constexpr int DOUBLED_MG = EG_TABLE + 6 * 64;
+    constexpr int DOUBLED_EG = DOUBLED_MG + 1;
+    constexpr int ISOLATED_MG = DOUBLED_EG + 1;
+    constexpr int ISOLATED_EG = ISOLATED_MG + 1;
+    constexpr int PASSED_MG = ISOLATED_EG + 1;   // [rank]
+    constexpr int PASSED_EG = PASSED_MG + 8;     // [rank]
+    constexpr int MOBILITY = PASSED_EG + 8;
+    constexpr int PARAMETER_COUNT = MOBILITY + 1;
+
+    using Parameters = std::array<double, PARAMETER_COUNT>;
+
+    // The weights currently compiled into EvalTables
+    Parameters defaultParameters();
+
+    // Features of a labelled position, white minus black where they are counts.
+    struct Position
+    {
+        uint8_t pieces[32];   // PieceIndex
+        uint8_t squares[32];
+        uint8_t pieceCount;
+        uint8_t phase;        // Clamped to MAX_PHASE
+        int8_t doubled, isolated;
+        int8_t passed[8];
+        int16_t mobility;
+        float result;         // 1 white wins, 0.5 draw, 0 black wins
+    };
+
+    Position extract(const ChessState& state, float result);
+
+    // Parses "<position> ... <result>", where the position is a 71-character state or
+    // a FEN/EPD record and the result is 1-0, 0-1, 1/2-1/2 or a decimal such as 0.5
+    // (bare integers are taken for FEN move counters). Returns false for anything else.
+    bool parseLine(std::string_view line, Position& position);
+
+    // Loads every parsable line of a file, memory-mapped and split across threads.
+    std::vector<Position> loadPositions(const std::string& path, int threads, size_t& skipped);
+
+    // Heuristic2 of the position under the given weights, before integer rounding
+    double evaluate(const Parameters& parameters, const Position& position);
+
+    // Mean squared error between results and sigmoid(k * eval / 400), base 10
+    double error(const Parameters& parameters, const std::vector<Position>& positions, double k, int threads);
+
+    // The k that best fits the current weights
+    double findScalingConstant(const Parameters& parameters, const std::vector<Position>& positions, int threads);
+
+    struct Options
+    {
+        int threads = 1;
+        int iterations = 2000;
+        double learningRate = 1.0;  // Adam step size, in centipawns
+        int reportEvery = 100;      // Iterations between progress lines on stderr, 0 for none
+    };
+
+    // Adam over full-batch gradients; returns the final error.
+    double tune(Parameters& parameters, const std::vector<Position>& positions, double k, const Options& options);
+
+    // Writes a replacement for EvalTables.hpp holding the rounded weights.
+    void writeHeader(const Parameters& parameters, std::ostream& out);
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+
+
+// Zobrist hashing keys, generated at compile time from a fixed seed so that
+// hashes are identical across runs and builds.
+namespace Zobrist
+{
+    struct Keys
+    {
+        uint64_t piece[12][64]; // Indexed by PieceIndex and square
+        uint64_t whiteToMove;
+        uint64_t castling[6];   // One per castling flag, in state string order
+        uint64_t enPassant[8];  // Indexed by en passant file
+    };
+
+    constexpr uint64_t splitMix64(uint64_t& seed)
+    {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr Keys generateKeys()
+    {
+        Keys keys{};
+        uint64_t seed = 0x5045524348464953ULL;
+        for (auto& piece : keys.piece)
+            for (auto& square : piece)
+                square = splitMix64(seed);
+        keys.whiteToMove = splitMix64(seed);
+        for (auto& flag : keys.castling)
+            flag = splitMix64(seed);
+        for (auto& file : keys.enPassant)
+            file = splitMix64(seed);
+        return keys;
+    }
+
+    inline constexpr Keys keys = generateKeys();
+}
@@ -1,69 +1,38 @@
 #include "ChessMove.hpp"
 
 
-ChessMove::ChessMove() : from({0, 0}), to({0, 0}), promotion(0) {}
-
-ChessMove::ChessMove(const ChessMove& other) : from(other.from), to(other.to), promotion(other.promotion) {}
-
-ChessMove::ChessMove(int fromRow, int fromCol, int toRow, int toCol, int promotion) : from({fromRow, fromCol}), to({toRow, toCol}), promotion(promotion) {}
-
-ChessMove& ChessMove::operator=(const ChessMove& other)
-{
-    from = other.from;
-    to = other.to;
-    promotion = other.promotion;
-    return *this;
-}
-
-ChessMove::~ChessMove() {}
-
-std::pair<int, int> ChessMove::getFrom() const
-{
-    return from;
-}
-
-std::pair<int, int> ChessMove::getTo() const
-{
-    return to;
-}
-
-int ChessMove::getPromotion() const
-{
-    return promotion;
-}
-
 void ChessMove::setFrom(std::pair<int, int> from)
 {
-    this->from = from;
+    data = pack((from.first & 7) * 8 + (from.second & 7), toSquare(), getFlag(), getPromotion());
 }
 
 void ChessMove::setTo(std::pair<int, int> to)
 {
-    this->to = to;
+    data = pack(fromSquare(), (to.first & 7) * 8 + (to.second & 7), getFlag(), getPromotion());
 }
 
 void ChessMove::setPromotion(int promotion)
 {
-    this->promotion = promotion;
+    data = pack(fromSquare(), toSquare(), getFlag(), promotion);
 }
 
-bool ChessMove::operator==(const ChessMove& other) const
-{
-    return from == other.from && to == other.to && promotion == other.promotion;
-}
-
-bool ChessMove::operator!=(const ChessMove& other) const
+void ChessMove::printMove() const
 {
-    return !(*this == other);
+    std::cout << (fromSquare() >> 3) << (fromSquare() & 7) << " -> " << (toSquare() >> 3) << (toSquare() & 7) << "\n";
 }
 
-void ChessMove::printMove() const
+void ChessMove::format(char* buffer) const
 {
-    std::cout << from.first << from.second << " -> " << to.first << to.second << "\n";
+    buffer[0] = static_cast<char>('0' + (fromSquare() >> 3));
+    buffer[1] = static_cast<char>('0' + (fromSquare() & 7));
+    buffer[2] = static_cast<char>('0' + (toSquare() >> 3));
+    buffer[3] = static_cast<char>('0' + (toSquare() & 7));
+    buffer[4] = static_cast<char>('0' + getPromotion());
 }
 
 std::string ChessMove::toString() const
 {
-    return std::to_string(from.first) + std::to_string(from.second) + std::to_string(to.first) + std::to_string(to.second)
-    + std::to_string(promotion);
-}
\ No newline at end of file
+    char buffer[5];
+    format(buffer);
+    return std::string(buffer, sizeof(buffer));
+}
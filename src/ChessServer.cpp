@@ -1,6 +1,35 @@
 #include "ChessServer.hpp"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
 
 
+static long long parseLimit(const httplib::Request& req, const char* name)
+{
+    if (!req.has_param(name))
+        return 0;
+    std::string value = req.get_param_value(name);
+    long long parsed = 0;
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+    if (error != std::errc() || end != value.data() + value.size() || parsed <= 0)
+        throw std::invalid_argument(std::string("Invalid ") + name + ": " + value);
+    return parsed;
+}
+
+SearchLimits ChessServer::parseLimits(const httplib::Request& req)
+{
+    SearchLimits limits;
+    long long depth = parseLimit(req, "depth");
+    long long movetime = parseLimit(req, "movetime");
+    long long nodes = parseLimit(req, "nodes");
+
+    limits.depth = static_cast<int>(std::min<long long>(depth, SearchStack::MAX_PLY - 1));
+    limits.nodes = static_cast<uint64_t>(nodes);
+    limits.movetime = std::chrono::milliseconds(std::min<long long>(movetime ? movetime : DEFAULT_MOVETIME_MS, MAX_MOVETIME_MS));
+    if (!depth && !movetime && !nodes)
+        limits.depth = DEFAULT_DEPTH;
+    return limits;
+}
 
 ChessServer::ChessServer() 
 {
@@ -20,8 +49,17 @@ ChessServer::ChessServer()
             return;
         }
 
+        SearchLimits limits;
+        try {
+            limits = parseLimits(req);
+        } catch (const std::invalid_argument& e) {
+            res.status = 400;
+            res.set_content(std::string("Bad Request: ") + e.what(), "text/plain");
+            return;
+        }
+
         try {
-            std::string bestMove = engine.getBestMove(req.body, 5); // Compute before responding
+            std::string bestMove = engine.getBestMove(req.body, limits); // Compute before responding
             std::cout << "Best move: " << bestMove << std::endl;
             res.set_content(bestMove, "text/plain");
         } catch (const std::exception& e) {
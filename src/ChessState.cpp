@@ -1,4 +1,7 @@
 #include "ChessState.hpp"
+#include "Attacks.hpp"
+#include "Zobrist.hpp"
+#include "PieceSquare.hpp"
 
 
 ChessState::ChessState(const std::string& stateStr)
@@ -9,7 +12,10 @@ ChessState::ChessState(const std::string& stateStr)
     // Fill board (first 64 characters)
     for (int i = 0; i < 8; i++)
         for (int j = 0; j < 8; j++)
-            this->state[i][j] = stateStr[i * 8 + j];
+            this->state[i][j] = '0';
+    for (int square = 0; square < 64; square++)
+        if (stateStr[square] != '0')
+            putPiece(stateStr[square], square);
 
     // Flags stored in remaining characters
     this->whiteToMove = stateStr[64] == '1';
@@ -19,6 +25,12 @@ ChessState::ChessState(const std::string& stateStr)
     this->whiteRookBMoved = stateStr[68] == '1';
     this->blackRookAMoved = stateStr[69] == '1';
     this->blackRookBMoved = stateStr[70] == '1';
+
+    key = computeKey();
+    PieceSquare::Scores scores = PieceSquare::evaluate(&state[0][0]);
+    mgScore = scores.mg;
+    egScore = scores.eg;
+    phase = scores.phase;
 }
 
 bool ChessState::checkIfStringIsValid(const std::string& state)
@@ -55,65 +67,64 @@ void ChessState::makeMove(const ChessMove& move)
     char movedPiece = state[from.first][from.second];
     char capturedPiece = state[to.first][to.second];
 
+    // Save what the move destroys
+    UndoRecord& record = undoStack.push();
+    record.prevKey = key;
+    record.prevCastling = castlingMask();
+    record.prevEnPassantFile = static_cast<int8_t>(enPassantSquare.second);
+    record.special = 0;
 
-    MoveRecord record{from, to, movedPiece, capturedPiece};
-
-    // Save previous flags
-    record.prevWhiteKingMoved = whiteKingMoved;
-    record.prevBlackKingMoved = blackKingMoved;
-    record.prevWhiteRookAMoved = whiteRookAMoved;
-    record.prevWhiteRookBMoved = whiteRookBMoved;
-    record.prevBlackRookAMoved = blackRookAMoved;
-    record.prevBlackRookBMoved = blackRookBMoved;
-    record.prevEnPassantSquare = enPassantSquare;
+    int fromSquare = squareOf(from.first, from.second);
+    int toSquare = squareOf(to.first, to.second);
 
     // --- Standard move: update board ---
-    state[to.first][to.second] = movedPiece;
-    state[from.first][from.second] = '0';
+    if (capturedPiece != '0')
+        removePiece(toSquare);
+    if (movedPiece != '0')
+        movePiece(fromSquare, toSquare);
 
     // --- Pawn promotion ---
     if ((movedPiece == 'P' && to.first == 0) || (movedPiece == 'p' && to.first == 7))
     {
+        char promotedPiece = movedPiece;
         int promotion = move.getPromotion();
         switch (promotion)
         {
         case 0:
-            state[to.first][to.second] = (movedPiece == 'P') ? 'Q' : 'q';
+            promotedPiece = (movedPiece == 'P') ? 'Q' : 'q';
             break;
         case 1:
-            state[to.first][to.second] = (movedPiece == 'P') ? 'R' : 'r';
+            promotedPiece = (movedPiece == 'P') ? 'R' : 'r';
             break;
         case 2:
-            state[to.first][to.second] = (movedPiece == 'P') ? 'N' : 'n';
+            promotedPiece = (movedPiece == 'P') ? 'N' : 'n';
             break;
         case 3:
-            state[to.first][to.second] = (movedPiece == 'P') ? 'B' : 'b';
+            promotedPiece = (movedPiece == 'P') ? 'B' : 'b';
             break;
         default:
             break;
         }
+        removePiece(toSquare);
+        putPiece(promotedPiece, toSquare);
+        record.special |= UndoRecord::PROMOTED;
     }
 
     // --- Castling ---
     if (movedPiece == 'K' || movedPiece == 'k')
     {
-        // King-side castling:
-        if (from.second == 4 && to.second == 6)
+        // King-side (to column 6) or queen-side (to column 2) castling:
+        if (from.second == 4 && (to.second == 6 || to.second == 2))
         {
-            record.isCastling = true;
-            record.rookFrom = {from.first, 7};
-            record.rookTo = {from.first, 5};
-            state[from.first][5] = state[from.first][7];
-            state[from.first][7] = '0';
-        }
-        // Queen-side castling:
-        else if (from.second == 4 && to.second == 2)
-        {
-            record.isCastling = true;
-            record.rookFrom = {from.first, 0};
-            record.rookTo = {from.first, 3};
-            state[from.first][3] = state[from.first][0];
-            state[from.first][0] = '0';
+            int rookFromSquare = squareOf(from.first, to.second == 6 ? 7 : 0);
+            int rookToSquare = squareOf(from.first, to.second == 6 ? 5 : 3);
+            if (pieceOn(rookFromSquare) != '0')
+            {
+                if (pieceOn(rookToSquare) != '0')
+                    removePiece(rookToSquare);
+                movePiece(rookFromSquare, rookToSquare);
+                record.special |= UndoRecord::CASTLED;
+            }
         }
         // Update king moved flag:
         if (movedPiece == 'K')
@@ -129,15 +140,15 @@ void ChessState::makeMove(const ChessMove& move)
         {
             // For en passant, the captured pawn lies behind the destination square.
             int captureRow = movingWhite ? to.first + 1 : to.first - 1;
-            if (isInsideBoard(captureRow, to.second) && state[captureRow][to.second] != '0')
+            if (captureRow >= 0 && captureRow < 8 && state[captureRow][to.second] != '0')
             {
-                record.isEnPassant = true;
-                record.enPassantCapturedPos = {captureRow, to.second};
+                record.special |= UndoRecord::EN_PASSANT;
                 capturedPiece = state[captureRow][to.second];
-                state[captureRow][to.second] = '0';
+                removePiece(squareOf(captureRow, to.second));
             }
         }
     }
+    record.capturedPiece = capturedPiece;
 
     // --- Update enPassantSquare ---
     enPassantSquare = {-1, -1}; // Reset by default
@@ -162,241 +173,270 @@ void ChessState::makeMove(const ChessMove& move)
             blackRookBMoved = true;
     }
 
-    // --- Record the move ---
-    moveHistory.push_back(record);
+    // --- Update the key for flags and en passant (pieces were hashed as they moved) ---
+    for (uint8_t changed = record.prevCastling ^ castlingMask(); changed; changed &= changed - 1)
+        key ^= Zobrist::keys.castling[lsb(changed)];
+    if (record.prevEnPassantFile != -1)
+        key ^= Zobrist::keys.enPassant[record.prevEnPassantFile];
+    if (enPassantSquare.second != -1)
+        key ^= Zobrist::keys.enPassant[enPassantSquare.second];
+    key ^= Zobrist::keys.whiteToMove;
 
     // --- Switch turn ---
     whiteToMove = !whiteToMove;
 }
 
 // =====================================================
-// unmakeMove: revert a move using data stored in the MoveRecord.
+// unmakeMove: revert the last move from its UndoRecord and the move itself.
 // =====================================================
 void ChessState::unmakeMove(const ChessMove& move)
 {
-    if (moveHistory.empty())
+    if (undoStack.empty())
         return;
 
-    MoveRecord record = moveHistory.back();
-    moveHistory.pop_back();
-
-    // Revert move of piece (king/pawn, etc.)
-    state[record.from.first][record.from.second] = record.movedPiece;
-    state[record.to.first][record.to.second] = record.capturedPiece;
-
-    // Undo pawn promotion if necessary:
-    if ((record.movedPiece == 'P' && record.to.first == 0) || (record.movedPiece == 'p' && record.to.first == 7))
-    {
-        state[record.from.first][record.from.second] = record.movedPiece;
-    }
+    const UndoRecord& record = undoStack.pop();
+    bool movingWhite = !whiteToMove;
 
-    // Revert castling:
-    if (record.isCastling)
-    {
-        // Move rook back:
-        state[record.rookFrom.first][record.rookFrom.second] = state[record.rookTo.first][record.rookTo.second];
-        state[record.rookTo.first][record.rookTo.second] = '0';
-    }
+    int fromSquare = move.fromSquare();
+    int toSquare = move.toSquare();
 
-    // Revert en passant:
-    if (record.isEnPassant)
+    // Revert castling first, so the rook leaves the square the king may return to.
+    if (record.special & UndoRecord::CASTLED)
     {
-        // Restore the captured pawn to its proper square.
-        auto pos = record.enPassantCapturedPos;
-        state[pos.first][pos.second] = (record.movedPiece == 'P') ? 'p' : 'P';
-    }
+        int row = rowOf(fromSquare);
+        bool kingSide = colOf(toSquare) == 6;
+        movePiece(squareOf(row, kingSide ? 5 : 3), squareOf(row, kingSide ? 7 : 0));
+    }
+
+    // Revert move of piece (king/pawn, etc.). The piece on the destination square
+    // may be a promoted one, in which case a pawn is put back instead.
+    char movedPiece = pieceOn(toSquare);
+    if (record.special & UndoRecord::PROMOTED)
+        movedPiece = movingWhite ? 'P' : 'p';
+    if (pieceOn(toSquare) != '0')
+        removePiece(toSquare);
+    if (movedPiece != '0')
+        putPiece(movedPiece, fromSquare);
+
+    // Restore the captured piece; an en passant pawn lies behind the destination square.
+    if (record.special & UndoRecord::EN_PASSANT)
+        putPiece(record.capturedPiece, toSquare + (movingWhite ? 8 : -8));
+    else if (record.capturedPiece != '0')
+        putPiece(record.capturedPiece, toSquare);
 
     // Restore previous flags
-    whiteKingMoved = record.prevWhiteKingMoved;
-    blackKingMoved = record.prevBlackKingMoved;
-    whiteRookAMoved = record.prevWhiteRookAMoved;
-    whiteRookBMoved = record.prevWhiteRookBMoved;
-    blackRookAMoved = record.prevBlackRookAMoved;
-    blackRookBMoved = record.prevBlackRookBMoved;
-    enPassantSquare = record.prevEnPassantSquare;
+    setCastlingMask(record.prevCastling);
+    enPassantSquare = record.prevEnPassantFile == -1
+        ? std::make_pair(-1, -1)
+        : std::make_pair(movingWhite ? 2 : 5, static_cast<int>(record.prevEnPassantFile));
+    key = record.prevKey;
 
     // Switch turn back.
     whiteToMove = !whiteToMove;
 }
 
+uint8_t ChessState::castlingMask() const
+{
+    return static_cast<uint8_t>(whiteKingMoved | blackKingMoved << 1 | whiteRookAMoved << 2 |
+                                whiteRookBMoved << 3 | blackRookAMoved << 4 | blackRookBMoved << 5);
+}
+
+void ChessState::setCastlingMask(uint8_t mask)
+{
+    whiteKingMoved = mask & 1;
+    blackKingMoved = mask & 2;
+    whiteRookAMoved = mask & 4;
+    whiteRookBMoved = mask & 8;
+    blackRookAMoved = mask & 16;
+    blackRookBMoved = mask & 32;
+}
+
 bool ChessState::isSquareAttacked(int row, int col, bool attackedByWhite) const
 {
-    // Pawn attacks:
-    if (attackedByWhite) {
-        if (isInsideBoard(row + 1, col + 1) && state[row + 1][col + 1] == 'P') return true;
-        if (isInsideBoard(row + 1, col - 1) && state[row + 1][col - 1] == 'P') return true;
-    }
-    else {
-        if (isInsideBoard(row - 1, col - 1) && state[row - 1][col - 1] == 'p') return true;
-        if (isInsideBoard(row - 1, col + 1) && state[row - 1][col + 1] == 'p') return true;
-    }
+    if (row < 0 || row >= 8 || col < 0 || col >= 8)
+        return false;
+    int square = squareOf(row, col);
+    return attackedByWhite ? isAttackedBy<WHITE>(square) : isAttackedBy<BLACK>(square);
+}
 
-    // Knight attacks:
-    const std::vector<std::pair<int,int>> knightOffsets = { {-2,-1}, {-2,1}, {2,-1}, {2,1}, {-1,-2}, {-1,2}, {1,-2}, {1,2} };
-    for (auto [dx, dy] : knightOffsets) {
-        int r = row + dx, c = col + dy;
-        if (isInsideBoard(r, c)) {
-            char piece = state[r][c];
-            if (attackedByWhite && piece == 'N') return true;
-            if (!attackedByWhite && piece == 'n') return true;
-        }
-    }
+template <Color By>
+bool ChessState::isAttackedBy(int square) const
+{
+    const Bitboard* attackerPieces = &pieces[makePiece(By, PAWN)];
+
+    // Pawn attacks: a pawn of the attacking side hits this square exactly when a
+    // pawn of the other side standing here would hit the pawn.
+    if (Attacks::pawn[By ^ 1][square] & attackerPieces[PAWN])
+        return true;
+
+    // Knight and king attacks:
+    if (Attacks::knight[square] & attackerPieces[KNIGHT])
+        return true;
+    if (Attacks::king[square] & attackerPieces[KING])
+        return true;
+
+    // Sliding pieces: bishops & queens (diagonals), rooks & queens (orthogonal)
+    Bitboard diagonal = attackerPieces[BISHOP] | attackerPieces[QUEEN];
+    if (diagonal && (Attacks::bishopAttacks(square, allPieces) & diagonal))
+        return true;
+    Bitboard straight = attackerPieces[ROOK] | attackerPieces[QUEEN];
+    if (straight && (Attacks::rookAttacks(square, allPieces) & straight))
+        return true;
 
-    // Sliding pieces: bishops & queens (diagonals)
-    const std::vector<std::pair<int,int>> diagonalOffsets = { {-1,-1}, {-1,1}, {1,-1}, {1,1} };
-    for (auto [dx, dy] : diagonalOffsets) 
-    {
-        int r = row + dx, c = col + dy;
-        while (isInsideBoard(r, c) && state[r][c] == '0') 
-        {
-            r += dx;
-            c += dy;
-        }
-        if (isInsideBoard(r, c)) 
-        {
-            char piece = state[r][c];
-            if (attackedByWhite && (piece == 'B' || piece == 'Q'))
-                return true;
-            if (!attackedByWhite && (piece == 'b' || piece == 'q'))
-                return true;
-        }
-    }
+    return false;
+}
 
-    // Sliding pieces: rooks & queens (orthogonal)
-    const std::vector<std::pair<int,int>> straightOffsets = { {-1,0}, {1,0}, {0,-1}, {0,1} };
-    for (auto [dx, dy] : straightOffsets) 
-    {
-        int r = row + dx, c = col + dy;
-        while (isInsideBoard(r, c) && state[r][c] == '0') 
-        {
-            r += dx;
-            c += dy;
-        }
-        if (isInsideBoard(r, c)) 
-        {
-            char piece = state[r][c];
-            if (attackedByWhite && (piece == 'R' || piece == 'Q'))
-                return true;
-            if (!attackedByWhite && (piece == 'r' || piece == 'q'))
-                return true;
-        }
-    }
+///////////////////////////////////////////////////
+// Board update helpers
+///////////////////////////////////////////////////
 
-    // King attacks:
-    for (int dx = -1; dx <= 1; ++dx)
-    {
-        for (int dy = -1; dy <= 1; ++dy)
-        {
-            if (dx == 0 && dy == 0) continue;
-            int r = row + dx, c = col + dy;
-            if (isInsideBoard(r, c)) 
-            {
-                char piece = state[r][c];
-                if (attackedByWhite && piece == 'K') return true;
-                if (!attackedByWhite && piece == 'k') return true;
-            }
-        }
-    }
+void ChessState::putPiece(char piece, int square)
+{
+    int index = pieceIndex(piece);
+    Bitboard bit = squareBit(square);
+    state[rowOf(square)][colOf(square)] = piece;
+    key ^= Zobrist::keys.piece[index][square];
+    if (index % 6 == PAWN)
+        pawnKey ^= Zobrist::keys.piece[index][square];
+    mgScore += PieceSquare::table.mg[index][square];
+    egScore += PieceSquare::table.eg[index][square];
+    phase += EvalTables::phaseWeight[index % 6];
+    if (network)
+        network->addPiece(accumulator, index, square);
+    pieces[index] |= bit;
+    occupancy[index < BLACK_PAWN ? WHITE : BLACK] |= bit;
+    allPieces |= bit;
+    if (index % 6 == KING)
+        updateKingSquare(index / 6);
+}
 
-    return false;
+void ChessState::removePiece(int square)
+{
+    int index = pieceIndex(pieceOn(square));
+    Bitboard bit = squareBit(square);
+    state[rowOf(square)][colOf(square)] = '0';
+    key ^= Zobrist::keys.piece[index][square];
+    if (index % 6 == PAWN)
+        pawnKey ^= Zobrist::keys.piece[index][square];
+    mgScore -= PieceSquare::table.mg[index][square];
+    egScore -= PieceSquare::table.eg[index][square];
+    phase -= EvalTables::phaseWeight[index % 6];
+    if (network)
+        network->removePiece(accumulator, index, square);
+    pieces[index] &= ~bit;
+    occupancy[index < BLACK_PAWN ? WHITE : BLACK] &= ~bit;
+    allPieces &= ~bit;
+    if (index % 6 == KING)
+        updateKingSquare(index / 6);
 }
 
-bool ChessState::isInsideBoard(int row, int col) const 
+void ChessState::attachNetwork(std::shared_ptr<const NNUE::Network> network)
 {
-    return row >= 0 && row < 8 && col >= 0 && col < 8;
+    this->network = std::move(network);
+    if (this->network)
+        this->network->refresh(accumulator, pieces);
 }
 
-bool ChessState::isOpponentPiece(char piece) const 
+void ChessState::updateKingSquare(int color)
 {
-    return (whiteToMove && piece >= 'a' && piece <= 'z') || (!whiteToMove && piece >= 'A' && piece <= 'Z');
+    Bitboard king = pieces[makePiece(color, KING)];
+    kingSquare[color] = king ? lsb(king) : -1;
 }
 
-bool ChessState::isOwnPiece(char piece) const 
+void ChessState::movePiece(int from, int to)
 {
-    return (whiteToMove && piece >= 'A' && piece <= 'Z') || (!whiteToMove && piece >= 'a' && piece <= 'z');
+    char piece = pieceOn(from);
+    removePiece(from);
+    putPiece(piece, to);
+}
+
+char ChessState::pieceOn(int square) const
+{
+    return state[rowOf(square)][colOf(square)];
 }
 
 bool ChessState::isTerminal()
 {
-    return isCheckmate() || isStalemate();
+    MoveList legalMoves;
+    NodeStatus status = nodeStatus(legalMoves);
+    return status == CHECKMATE || status == STALEMATE;
+}
+
+ChessState::NodeStatus ChessState::nodeStatus(MoveList& legalMoves)
+{
+    MoveGenMasks masks = computeMoveGenMasks();
+    generateMoves(LEGAL, masks, legalMoves);
+    if (legalMoves.empty())
+        return masks.checkers ? CHECKMATE : STALEMATE;
+    return masks.checkers ? IN_CHECK : NORMAL;
 }
 
 bool ChessState::isInCheck(bool byWhite) const
 {
-    int kingRow = byWhite ? getWhiteKingRow() : getBlackKingRow();
-    int kingCol = byWhite ? getWhiteKingCol() : getBlackKingCol();
-    return isSquareAttacked(kingRow, kingCol, !byWhite);
+    int king = kingSquare[byWhite ? WHITE : BLACK];
+    return king >= 0 && (byWhite ? isAttackedBy<BLACK>(king) : isAttackedBy<WHITE>(king));
 }
 
 std::vector<ChessMove> ChessState::getLegalMoves()
 {
-    std::vector<ChessMove> legalMoves;
-    for (int row = 0; row < 8; ++row) 
-    {
-        for (int col = 0; col < 8; ++col) 
-        {
-            if (isOwnPiece(state[row][col])) 
-            {
-                switch (state[row][col]) {
-                    case 'P':
-                    case 'p':
-                        getPawnMoves(row, col, legalMoves);
-                        break;
-                    case 'N':
-                    case 'n':
-                        getKnightMoves(row, col, legalMoves);
-                        break;
-                    case 'B':
-                    case 'b':
-                        getBishopMoves(row, col, legalMoves);
-                        break;
-                    case 'R':
-                    case 'r':
-                        getRookMoves(row, col, legalMoves);
-                        break;
-                    case 'Q':
-                    case 'q':
-                        getQueenMoves(row, col, legalMoves);
-                        break;
-                    case 'K':
-                    case 'k':
-                        getKingMoves(row, col, legalMoves);
-                        break;
-                    default:
-
-                        break;
-                }
-            }
-        }
-    }
-    return legalMoves;
+    MoveList legalMoves;
+    generateLegalMoves(legalMoves);
+    return std::vector<ChessMove>(legalMoves.begin(), legalMoves.end());
 }
 
-char ChessState::getPieceAt(int row, int col) const 
+void ChessState::generateLegalMoves(MoveList& legalMoves)
 {
-    return state[row][col];
+    generateMoves(LEGAL, legalMoves);
 }
 
-bool ChessState::isLegalMove(const ChessMove& move)
+void ChessState::generateMoves(GenType type, MoveList& moves)
 {
-    bool ret;
-    makeMove(move);
-    // Note: We check the king of the side that just moved.
-    if (!whiteToMove) {
-        int kingRow = getWhiteKingRow();
-        int kingCol = getWhiteKingCol();
-        ret = !isSquareAttacked(kingRow, kingCol, /*attackedByWhite=*/false);
-    }
-    else {
-        int kingRow = getBlackKingRow();
-        int kingCol = getBlackKingCol();
-        ret = !isSquareAttacked(kingRow, kingCol, /*attackedByWhite=*/true);
+    generateMoves(type, computeMoveGenMasks(), moves);
+}
+
+void ChessState::generateMoves(GenType type, MoveGenMasks masks, MoveList& moves)
+{
+    if (whiteToMove)
+        generateMoves<WHITE>(type, masks, moves);
+    else
+        generateMoves<BLACK>(type, masks, moves);
+}
+
+template <Color Us>
+void ChessState::generateMoves(GenType type, MoveGenMasks masks, MoveList& moves)
+{
+    moves.clear();
+
+    // Staged (pseudo-legal) generation ignores checks and pins; the caller
+    // tests each move with isLegal before playing it.
+    if (type != LEGAL)
+    {
+        masks.checkMask = ~Bitboard(0);
+        masks.pinned = 0;
     }
-    unmakeMove(move);
 
-    return ret;
+    // In double check only the king can move.
+    if (type != LEGAL || popCount(masks.checkers) <= 1)
+    {
+        for (Bitboard bb = pieces[makePiece(Us, PAWN)]; bb; )
+            getPawnMoves<Us>(popLsb(bb), type, masks, moves);
+        for (Bitboard bb = pieces[makePiece(Us, KNIGHT)]; bb; )
+            getKnightMoves<Us>(popLsb(bb), type, masks, moves);
+        for (Bitboard bb = pieces[makePiece(Us, BISHOP)]; bb; )
+            getBishopMoves<Us>(popLsb(bb), type, masks, moves);
+        for (Bitboard bb = pieces[makePiece(Us, ROOK)]; bb; )
+            getRookMoves<Us>(popLsb(bb), type, masks, moves);
+        for (Bitboard bb = pieces[makePiece(Us, QUEEN)]; bb; )
+            getQueenMoves<Us>(popLsb(bb), type, masks, moves);
+    }
+    for (Bitboard bb = pieces[makePiece(Us, KING)]; bb; )
+        getKingMoves<Us>(popLsb(bb), type, masks, moves);
 }
 
+char ChessState::getPieceAt(int row, int col) const 
+{
+    return state[row][col];
+}
 
 ///////////////////////////////////////////////////
 // King positions
@@ -405,62 +445,22 @@ bool ChessState::isLegalMove(const ChessMove& move)
 
 int ChessState::getWhiteKingRow() const 
 {
-    for (int i = 0; i < 8; i++) 
-    {
-        for (int j = 0; j < 8; j++) 
-        {
-            if (state[i][j] == 'K') 
-            {
-                return i;
-            }
-        }
-    }
-    return -1;
+    return kingSquare[WHITE] < 0 ? -1 : rowOf(kingSquare[WHITE]);
 }
 
 int ChessState::getBlackKingRow() const 
 {
-    for (int i = 0; i < 8; i++) 
-    {
-        for (int j = 0; j < 8; j++) 
-        {
-            if (state[i][j] == 'k') 
-            {
-                return i;
-            }
-        }
-    }
-    return -1;
+    return kingSquare[BLACK] < 0 ? -1 : rowOf(kingSquare[BLACK]);
 }
 
 int ChessState::getWhiteKingCol() const 
 {
-    for (int i = 0; i < 8; i++) 
-    {
-        for (int j = 0; j < 8; j++) 
-        {
-            if (state[i][j] == 'K') 
-            {
-                return j;
-            }
-        }
-    }
-    return -1;
+    return kingSquare[WHITE] < 0 ? -1 : colOf(kingSquare[WHITE]);
 }
 
 int ChessState::getBlackKingCol() const 
 {
-    for (int i = 0; i < 8; i++) 
-    {
-        for (int j = 0; j < 8; j++) 
-        {
-            if (state[i][j] == 'k') 
-            {
-                return j;
-            }
-        }
-    }
-    return -1;
+    return kingSquare[BLACK] < 0 ? -1 : colOf(kingSquare[BLACK]);
 }
 
 ///////////////////////////////////////////////////
@@ -469,26 +469,102 @@ int ChessState::getBlackKingCol() const
 
 bool ChessState::isCheckmate()
 {
-    int kingRow = whiteToMove ? getWhiteKingRow() : getBlackKingRow();
-    int kingCol = whiteToMove ? getWhiteKingCol() : getBlackKingCol();
-    bool inCheck = isSquareAttacked(kingRow, kingCol, !whiteToMove);
-    if (!inCheck)
-        return false;
-    std::vector<ChessMove> legalMoves = getLegalMoves();
-    return legalMoves.empty();
+    MoveList legalMoves;
+    return nodeStatus(legalMoves) == CHECKMATE;
 }
 
 bool ChessState::isStalemate()
 {
-    int kingRow = whiteToMove ? getWhiteKingRow() : getBlackKingRow();
-    int kingCol = whiteToMove ? getWhiteKingCol() : getBlackKingCol();
-    bool inCheck = isSquareAttacked(kingRow, kingCol, !whiteToMove);
-    if (inCheck)
-        return false;
-    std::vector<ChessMove> legalMoves = getLegalMoves();
-    return legalMoves.empty();
+    MoveList legalMoves;
+    return nodeStatus(legalMoves) == STALEMATE;
+}
+
+
+///////////////////////////////////////////////////
+// Perft and hashing
+///////////////////////////////////////////////////
+
+uint64_t ChessState::perft(int depth)
+{
+    if (depth == 0)
+        return 1;
+
+    MoveList legalMoves;
+    generateLegalMoves(legalMoves);
+
+    // Bulk counting: the moves at the last ply are not made.
+    if (depth == 1)
+        return legalMoves.size();
+
+    uint64_t nodes = 0;
+    for (const ChessMove& move : legalMoves)
+    {
+        makeMove(move);
+        nodes += perft(depth - 1);
+        unmakeMove(move);
+    }
+    return nodes;
+}
+
+uint64_t ChessState::computeKey() const
+{
+    uint64_t key = 0;
+    for (int piece = WHITE_PAWN; piece <= BLACK_KING; piece++)
+    {
+        Bitboard bb = pieces[piece];
+        while (bb)
+            key ^= Zobrist::keys.piece[piece][popLsb(bb)];
+    }
+
+    if (whiteToMove)
+        key ^= Zobrist::keys.whiteToMove;
+
+    const bool flags[6] = { whiteKingMoved, blackKingMoved, whiteRookAMoved, whiteRookBMoved, blackRookAMoved, blackRookBMoved };
+    for (int i = 0; i < 6; i++)
+        if (flags[i])
+            key ^= Zobrist::keys.castling[i];
+
+    if (enPassantSquare.second != -1)
+        key ^= Zobrist::keys.enPassant[enPassantSquare.second];
+
+    return key;
+}
+
+uint64_t ChessState::computePawnKey() const
+{
+    uint64_t key = 0;
+    for (int piece : { WHITE_PAWN, BLACK_PAWN })
+    {
+        Bitboard bb = pieces[piece];
+        while (bb)
+            key ^= Zobrist::keys.piece[piece][popLsb(bb)];
+    }
+    return key;
 }
 
+int ChessState::psqScore() const
+{
+    return PieceSquare::interpolate({mgScore, egScore, phase});
+}
+
+int ChessState::mobility(Color color) const
+{
+    return color == WHITE ? mobility<WHITE>() : mobility<BLACK>();
+}
+
+template <Color Us>
+int ChessState::mobility() const
+{
+    Bitboard targets = ~occupancy[Us];
+    int count = 0;
+    for (Bitboard bb = pieces[makePiece(Us, KNIGHT)]; bb; )
+        count += popCount(Attacks::knight[popLsb(bb)] & targets);
+    for (Bitboard bb = pieces[makePiece(Us, BISHOP)] | pieces[makePiece(Us, QUEEN)]; bb; )
+        count += popCount(Attacks::bishopAttacks(popLsb(bb), allPieces) & targets);
+    for (Bitboard bb = pieces[makePiece(Us, ROOK)] | pieces[makePiece(Us, QUEEN)]; bb; )
+        count += popCount(Attacks::rookAttacks(popLsb(bb), allPieces) & targets);
+    return count;
+}
 
 ///////////////////////////////////////////////////
 // Print board
@@ -520,244 +596,331 @@ void ChessState::printBoard() const
 }
 
 ///////////////////////////////////////////////////
-// Pieces moves
+// Legal move generation masks
 ///////////////////////////////////////////////////
 
+Bitboard ChessState::attackersTo(int square, Bitboard occupied) const
+{
+    return (Attacks::pawn[BLACK][square] & pieces[WHITE_PAWN])
+         | (Attacks::pawn[WHITE][square] & pieces[BLACK_PAWN])
+         | (Attacks::knight[square] & (pieces[WHITE_KNIGHT] | pieces[BLACK_KNIGHT]))
+         | (Attacks::king[square] & (pieces[WHITE_KING] | pieces[BLACK_KING]))
+         | (Attacks::bishopAttacks(square, occupied) &
+            (pieces[WHITE_BISHOP] | pieces[BLACK_BISHOP] | pieces[WHITE_QUEEN] | pieces[BLACK_QUEEN]))
+         | (Attacks::rookAttacks(square, occupied) &
+            (pieces[WHITE_ROOK] | pieces[BLACK_ROOK] | pieces[WHITE_QUEEN] | pieces[BLACK_QUEEN]));
+}
 
-void ChessState::getPawnMoves(int row, int col, std::vector<ChessMove>& legalMoves)
+ChessState::MoveGenMasks ChessState::computeMoveGenMasks() const
 {
-    int direction = whiteToMove ? -1 : 1;
-    int startRow = whiteToMove ? 6 : 1;
+    return whiteToMove ? computeMoveGenMasks<WHITE>() : computeMoveGenMasks<BLACK>();
+}
 
-    // Move forward
-    if (isInsideBoard(row + direction, col) && state[row + direction][col] == '0')
+template <Color Us>
+ChessState::MoveGenMasks ChessState::computeMoveGenMasks() const
+{
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    MoveGenMasks masks{kingSquare[Us], 0, ~Bitboard(0), 0};
+    if (masks.kingSquare < 0)
+        return masks;
+
+    // Checks
+    masks.checkers = attackersTo(masks.kingSquare, allPieces) & occupancy[Them];
+    if (masks.checkers)
     {
-        // Promotion
-        if (row + direction == 0 || row + direction == 7)
-        {
-            for (int i = 0; i < 4; i++) // 0: Queen, 1: Rook, 2: Knight, 3: Bishop
-            {
-                ChessMove move(row, col, row + direction, col, i);
-                if (isLegalMove(move))
-                    legalMoves.push_back(move);
-            }
-        }
-        else
-        {
-            ChessMove move(row, col, row + direction, col, 0);
-            if (isLegalMove(move))
-                legalMoves.push_back(move);
-        }
+        int checker = lsb(masks.checkers);
+        masks.checkMask = popCount(masks.checkers) > 1
+            ? 0 : masks.checkers | Attacks::between[masks.kingSquare][checker];
     }
 
-    // First move: double step
-    if (row == startRow && state[row + direction][col] == '0' && state[row + 2 * direction][col] == '0')
+    // Pins: enemy sliders that would attack the king through exactly one own piece.
+    Bitboard diagonal = pieces[makePiece(Them, BISHOP)] | pieces[makePiece(Them, QUEEN)];
+    Bitboard straight = pieces[makePiece(Them, ROOK)] | pieces[makePiece(Them, QUEEN)];
+    Bitboard snipers = (Attacks::bishopAttacks(masks.kingSquare, 0) & diagonal)
+                     | (Attacks::rookAttacks(masks.kingSquare, 0) & straight);
+    while (snipers)
     {
-        ChessMove move(row, col, row + 2 * direction, col, 0);
-        if (isLegalMove(move))
-            legalMoves.push_back(move);
+        Bitboard blockers = Attacks::between[masks.kingSquare][popLsb(snipers)] & allPieces;
+        if (popCount(blockers) == 1)
+            masks.pinned |= blockers & occupancy[Us];
     }
+    return masks;
+}
 
-    // Capture
-    for (int i = -1; i <= 1; i += 2)
+Bitboard ChessState::pinMask(int square, const MoveGenMasks& masks) const
+{
+    // A pinned piece may only move along the line through its king.
+    if (masks.pinned & squareBit(square))
+        return Attacks::line[masks.kingSquare][square];
+    return ~Bitboard(0);
+}
+
+void ChessState::addMoves(int from, Bitboard targets, MoveList& moves) const
+{
+    while (targets)
     {
-        if (isInsideBoard(row + direction, col + i) && isOpponentPiece(state[row + direction][col + i]))
-        {
-            // Promotion
-            if (row + direction == 0 || row + direction == 7)
-            {
-                for (int p = 0; p < 4; p++)
-                {
-                    ChessMove move(row, col, row + direction, col + i, p);
-                    if (isLegalMove(move))
-                        legalMoves.push_back(move);
-                }
-            }
-            else
-            {
-                ChessMove move(row, col, row + direction, col + i, 0);
-                if (isLegalMove(move))
-                    legalMoves.push_back(move);
-            }
-        }
+        int to = popLsb(targets);
+        moves.push_back(ChessMove::fromSquares(from, to));
     }
+}
 
-    // En passant
-    if (enPassantSquare.first != -1 && enPassantSquare.second != -1)
+template <Color Us>
+bool ChessState::isLegalEnPassant(int from, int to, int kingSquare) const
+{
+    if (kingSquare < 0)
+        return true;
+
+    // En passant removes two pawns from the board at once, which can uncover a
+    // slider on the king (including along the rank), so test the resulting board.
+    int captured = squareOf(rowOf(from), colOf(to));
+    Bitboard occupied = (allPieces ^ squareBit(from) ^ squareBit(captured)) | squareBit(to);
+    Bitboard enemies = occupancy[Us ^ 1] & ~squareBit(captured);
+    return !(attackersTo(kingSquare, occupied) & enemies);
+}
+
+template <Color Us>
+Bitboard ChessState::targetMask(GenType type) const
+{
+    switch (type)
     {
-        if (row == (whiteToMove ? 3 : 4) && std::abs(col - enPassantSquare.second) == 1 &&
-            enPassantSquare.first == row)
-        {
-            ChessMove move(row, col, row + direction, enPassantSquare.second, 0);
-            if (isLegalMove(move))
-                legalMoves.push_back(move);
-        }
+        case CAPTURES: return occupancy[Us ^ 1];
+        case QUIETS:   return ~allPieces;
+        default:       return ~occupancy[Us];
     }
 }
 
-void ChessState::getKnightMoves(int row, int col, std::vector<ChessMove>& legalMoves)
+bool ChessState::isPseudoLegal(const ChessMove& move) const
 {
-    for (auto [i, j] : std::vector<std::pair<int, int>>{{-2, -1}, {-2, 1}, {2, -1}, {2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}}) 
-    {
-        if (!isInsideBoard(row + i, col + j)) continue;
+    return whiteToMove ? isPseudoLegal<WHITE>(move) : isPseudoLegal<BLACK>(move);
+}
 
-        // Check if the move is legal
-        if (!isLegalMove(ChessMove(row, col, row + i, col + j, 0))) continue;
+template <Color Us>
+bool ChessState::isPseudoLegal(const ChessMove& move) const
+{
+    constexpr int forward = Us == WHITE ? -8 : 8;
+    constexpr int startRow = Us == WHITE ? 6 : 1;
+    int from = move.fromSquare(), to = move.toSquare();
+    if (from == to || !(occupancy[Us] & squareBit(from)) || (occupancy[Us] & squareBit(to)))
+        return false;
 
-        // Check if the move is inside the board and if it captures an opponent piece
-        if (isInsideBoard(row + i, col + j) && !isOwnPiece(state[row + i][col + j])) 
+    switch (pieceIndex(pieceOn(from)) % 6)
+    {
+        case PAWN:
         {
-            legalMoves.push_back(ChessMove(row, col, row + i, col + j, 0));
+            if (rowOf(to) != 0 && rowOf(to) != 7 && move.getPromotion() != 0)
+                return false;
+            if (to == from + forward)
+                return pieceOn(to) == '0';
+            if (to == from + 2 * forward)
+                return rowOf(from) == startRow && pieceOn(from + forward) == '0' && pieceOn(to) == '0';
+            if (Attacks::pawn[Us][from] & squareBit(to))
+                return (occupancy[Us ^ 1] & squareBit(to)) ||
+                       (enPassantSquare.first != -1 && to == squareOf(enPassantSquare.first, enPassantSquare.second));
+            return false;
+        }
+        case KNIGHT:
+            return Attacks::knight[from] & squareBit(to);
+        case BISHOP:
+            return Attacks::bishopAttacks(from, allPieces) & squareBit(to);
+        case ROOK:
+            return Attacks::rookAttacks(from, allPieces) & squareBit(to);
+        case QUEEN:
+            return Attacks::queenAttacks(from, allPieces) & squareBit(to);
+        default:
+        {
+            if (Attacks::king[from] & squareBit(to))
+                return true;
+            MoveList castling;
+            getCastlingMoves<Us>(castling);
+            for (const ChessMove& candidate : castling)
+                if (candidate == move)
+                    return true;
+            return false;
         }
     }
 }
 
-void ChessState::getBishopMoves(int row, int col, std::vector<ChessMove>& legalMoves)
+bool ChessState::isLegal(const ChessMove& move, const MoveGenMasks& masks) const
+{
+    return whiteToMove ? isLegal<WHITE>(move, masks) : isLegal<BLACK>(move, masks);
+}
+
+template <Color Us>
+bool ChessState::isLegal(const ChessMove& move, const MoveGenMasks& masks) const
 {
-    for (int i = -1; i <= 1; i += 2) 
+    if (masks.kingSquare < 0)
+        return true;
+
+    int from = move.fromSquare(), to = move.toSquare();
+    if (from == masks.kingSquare)
     {
-        for (int j = -1; j <= 1; j += 2) 
-        {
-            int r = row + i, c = col + j;
-            while (isInsideBoard(r, c) && !isOwnPiece(state[r][c])) 
-            {
-                if (!isLegalMove(ChessMove(row, col, r, c, 0))) break;
-                legalMoves.push_back(ChessMove(row, col, r, c, 0));
-                if (isOpponentPiece(state[r][c])) break;
-                r += i;
-                c += j;
-            }
-        }
+        // Castling is fully checked when it is generated.
+        if (std::abs(colOf(to) - colOf(from)) == 2)
+            return true;
+        return !(attackersTo(to, allPieces ^ squareBit(from)) & occupancy[Us ^ 1]);
     }
+
+    if (popCount(masks.checkers) > 1)
+        return false;
+
+    if ((pieces[makePiece(Us, PAWN)] & squareBit(from)) && colOf(from) != colOf(to) && pieceOn(to) == '0')
+        return isLegalEnPassant<Us>(from, to, masks.kingSquare);
+
+    return masks.checkMask & pinMask(from, masks) & squareBit(to);
 }
 
-void ChessState::getRookMoves(int row, int col, std::vector<ChessMove>& legalMoves)
+///////////////////////////////////////////////////
+// Pieces moves
+///////////////////////////////////////////////////
+
+
+template <Color Us>
+void ChessState::getPawnMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves)
 {
-    for (int i = -1; i <= 1; i += 2) 
+    constexpr int forward = Us == WHITE ? -8 : 8;
+    constexpr int startRow = Us == WHITE ? 6 : 1;
+    constexpr int lastRow = Us == WHITE ? 0 : 7;
+    int row = rowOf(square), col = colOf(square);
+    if (row == lastRow)
+        return;
+
+    Bitboard allowed = masks.checkMask & pinMask(square, masks);
+    bool promotionRow = row + forward / 8 == lastRow;
+
+    auto addPawnMove = [&](int to)
     {
-        int r = row + i, c = col;
-        while (isInsideBoard(r, c) && !isOwnPiece(state[r][c])) 
+        if (!(allowed & squareBit(to)))
+            return;
+        // Promotion
+        if (promotionRow)
         {
-            if (!isLegalMove(ChessMove(row, col, r, c, 0))) break;
-            legalMoves.push_back(ChessMove(row, col, r, c, 0));
-            if (isOpponentPiece(state[r][c])) break;
-            r += i;
+            for (int i = 0; i < 4; i++) // 0: Queen, 1: Rook, 2: Knight, 3: Bishop
+                moves.push_back(ChessMove::fromSquares(square, to, ChessMove::PROMOTION, i));
         }
-
-        r = row, c = col + i;
-        while (isInsideBoard(r, c) && !isOwnPiece(state[r][c])) 
+        else
         {
-            if (!isLegalMove(ChessMove(row, col, r, c, 0))) break;
-            legalMoves.push_back(ChessMove(row, col, r, c, 0));
-            if (isOpponentPiece(state[r][c])) break;
-            c += i;
+            moves.push_back(ChessMove::fromSquares(square, to));
         }
+    };
+
+    // Move forward. Promotions are generated with the captures.
+    int push = square + forward;
+    if (!(allPieces & squareBit(push)))
+    {
+        if (type == LEGAL || (type == CAPTURES) == promotionRow)
+            addPawnMove(push);
+
+        // First move: double step
+        if (type != CAPTURES && row == startRow && !(allPieces & squareBit(push + forward)))
+            addPawnMove(push + forward);
     }
-}
 
-void ChessState::getQueenMoves(int row, int col, std::vector<ChessMove>& legalMoves)
-{
-    for (int i = -1; i <= 1; i++) 
+    if (type == QUIETS)
+        return;
+
+    // Capture
+    Bitboard captures = Attacks::pawn[Us][square] & occupancy[Us ^ 1];
+    while (captures)
+        addPawnMove(popLsb(captures));
+
+    // En passant
+    if (enPassantSquare.first == rowOf(push) && std::abs(col - enPassantSquare.second) == 1)
     {
-        for (int j = -1; j <= 1; j++) 
-        {
-            if (i != 0 || j != 0) 
-            {
-                int r = row + i, c = col + j;
-                while (isInsideBoard(r, c) && !isOwnPiece(state[r][c])) 
-                {
-                    if (!isLegalMove(ChessMove(row, col, r, c, 0))) break;
-                    legalMoves.push_back(ChessMove(row, col, r, c, 0));
-                    if (isOpponentPiece(state[r][c])) break;
-                    r += i;
-                    c += j;
-                }
-            }
-        }
+        int to = squareOf(enPassantSquare.first, enPassantSquare.second);
+        if (type != LEGAL || ((pinMask(square, masks) & squareBit(to)) && isLegalEnPassant<Us>(square, to, masks.kingSquare)))
+            moves.push_back(ChessMove::fromSquares(square, to, ChessMove::EN_PASSANT));
     }
 }
 
-void ChessState::getKingMoves(int row, int col, std::vector<ChessMove>& legalMoves)
+template <Color Us>
+void ChessState::getKnightMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves)
+{
+    // A pinned knight can never stay on its pin line.
+    if (masks.pinned & squareBit(square))
+        return;
+    addMoves(square, Attacks::knight[square] & targetMask<Us>(type) & masks.checkMask, moves);
+}
+
+template <Color Us>
+void ChessState::getBishopMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves)
 {
-    // Standard king moves
-    for (int i = -1; i <= 1; i++)
+    Bitboard targets = Attacks::bishopAttacks(square, allPieces) & targetMask<Us>(type);
+    addMoves(square, targets & masks.checkMask & pinMask(square, masks), moves);
+}
+
+template <Color Us>
+void ChessState::getRookMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves)
+{
+    Bitboard targets = Attacks::rookAttacks(square, allPieces) & targetMask<Us>(type);
+    addMoves(square, targets & masks.checkMask & pinMask(square, masks), moves);
+}
+
+template <Color Us>
+void ChessState::getQueenMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves)
+{
+    Bitboard targets = Attacks::queenAttacks(square, allPieces) & targetMask<Us>(type);
+    addMoves(square, targets & masks.checkMask & pinMask(square, masks), moves);
+}
+
+template <Color Us>
+void ChessState::getKingMoves(int square, GenType type, const MoveGenMasks& masks, MoveList& moves)
+{
+    // Standard king moves. The king is lifted off the board for the attack test so
+    // it cannot hide behind itself when stepping away from a slider.
+    Bitboard occupied = allPieces ^ squareBit(square);
+    Bitboard targets = Attacks::king[square] & targetMask<Us>(type);
+    while (targets)
     {
-        for (int j = -1; j <= 1; j++)
-        {
-            if (i != 0 || j != 0)
-            {
-                int r = row + i, c = col + j;
-                if (isInsideBoard(r, c) && !isOwnPiece(state[r][c]))
-                {
-                    ChessMove move(row, col, r, c, 0);
-                    if (isLegalMove(move))
-                        legalMoves.push_back(move);
-                }
-            }
-        }
+        int to = popLsb(targets);
+        if (type != LEGAL || !(attackersTo(to, occupied) & occupancy[Us ^ 1]))
+            moves.push_back(ChessMove::fromSquares(square, to));
     }
 
-    // Castling
-    if (whiteToMove)
+    if (type != CAPTURES && !masks.checkers)
+        getCastlingMoves<Us>(moves);
+}
+
+template <Color Us>
+void ChessState::getCastlingMoves(MoveList& moves) const
+{
+    constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+    constexpr int row = Us == WHITE ? 7 : 0;
+    constexpr int kingSquare = squareOf(row, 4);
+    constexpr char king = Us == WHITE ? 'K' : 'k';
+    constexpr char rook = Us == WHITE ? 'R' : 'r';
+    bool kingMoved = Us == WHITE ? whiteKingMoved : blackKingMoved;
+    bool rookAMoved = Us == WHITE ? whiteRookAMoved : blackRookAMoved;
+    bool rookBMoved = Us == WHITE ? whiteRookBMoved : blackRookBMoved;
+
+    if (kingMoved || state[row][4] != king)
+        return;
+
+    // King-side
+    if (!rookBMoved && state[row][5] == '0' && state[row][6] == '0' && state[row][7] == rook &&
+        !isAttackedBy<Them>(kingSquare) && !isAttackedBy<Them>(kingSquare + 1) && !isAttackedBy<Them>(kingSquare + 2))
     {
-        if (!whiteKingMoved)
-        {
-            // King-side
-            if (!whiteRookBMoved && state[7][5] == '0' && state[7][6] == '0' && state[7][7] == 'R' &&
-                !isSquareAttacked(7, 4, false) && !isSquareAttacked(7, 5, false) && !isSquareAttacked(7, 6, false))
-            {
-                ChessMove move(7, 4, 7, 6, 0);
-                if (isLegalMove(move))
-                    legalMoves.push_back(move);
-            }
-            // Queen-side
-            if (!whiteRookAMoved && state[7][1] == '0' && state[7][2] == '0' && state[7][3] == '0' && state[7][0] == 'R' &&
-                !isSquareAttacked(7, 4, false) && !isSquareAttacked(7, 3, false) && !isSquareAttacked(7, 2, false))
-            {
-                ChessMove move(7, 4, 7, 2, 0);
-                if (isLegalMove(move))
-                    legalMoves.push_back(move);
-            }
-        }
+        moves.push_back(ChessMove::fromSquares(kingSquare, kingSquare + 2, ChessMove::CASTLING));
     }
-    else
+    // Queen-side
+    if (!rookAMoved && state[row][1] == '0' && state[row][2] == '0' && state[row][3] == '0' && state[row][0] == rook &&
+        !isAttackedBy<Them>(kingSquare) && !isAttackedBy<Them>(kingSquare - 1) && !isAttackedBy<Them>(kingSquare - 2))
     {
-        if (!blackKingMoved)
-        {
-            // King-side
-            if (!blackRookBMoved && state[0][5] == '0' && state[0][6] == '0' && state[0][7] == 'r' &&
-                !isSquareAttacked(0, 4, true) && !isSquareAttacked(0, 5, true) && !isSquareAttacked(0, 6, true))
-            {
-                ChessMove move(0, 4, 0, 6, 0);
-                if (isLegalMove(move))
-                    legalMoves.push_back(move);
-            }
-            // Queen-side
-            if (!blackRookAMoved && state[0][1] == '0' && state[0][2] == '0' && state[0][3] == '0' && state[0][0] == 'r' &&
-                !isSquareAttacked(0, 4, true) && !isSquareAttacked(0, 3, true) && !isSquareAttacked(0, 2, true))
-            {
-                ChessMove move(0, 4, 0, 2, 0);
-                if (isLegalMove(move))
-                    legalMoves.push_back(move);
-            }
-        }
+        moves.push_back(ChessMove::fromSquares(kingSquare, kingSquare - 2, ChessMove::CASTLING));
     }
 }
 
 std::string ChessState::toString() const
 {
-    std::string stateStr;
-    for (int i = 0; i < 8; i++)
-        for (int j = 0; j < 8; j++)
-            stateStr += state[i][j];
-
-    stateStr += whiteToMove ? "1" : "0";
-    stateStr += whiteKingMoved ? "1" : "0";
-    stateStr += blackKingMoved ? "1" : "0";
-    stateStr += whiteRookAMoved ? "1" : "0";
-    stateStr += whiteRookBMoved ? "1" : "0";
-    stateStr += blackRookAMoved ? "1" : "0";
-    stateStr += blackRookBMoved ? "1" : "0";
+    // Built in place: the board is 64 contiguous characters followed by 7 flags.
+    std::string stateStr(&state[0][0], 64);
+    stateStr.resize(71);
+    stateStr[64] = whiteToMove ? '1' : '0';
+    stateStr[65] = whiteKingMoved ? '1' : '0';
+    stateStr[66] = blackKingMoved ? '1' : '0';
+    stateStr[67] = whiteRookAMoved ? '1' : '0';
+    stateStr[68] = whiteRookBMoved ? '1' : '0';
+    stateStr[69] = blackRookAMoved ? '1' : '0';
+    stateStr[70] = blackRookBMoved ? '1' : '0';
 
     return stateStr;
 }
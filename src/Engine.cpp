@@ -1,18 +1,33 @@
 #include "Engine.hpp"
+#include "MovePicker.hpp"
+#include <cstdlib>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <thread>
 #include <tuple>
 #include <vector>
 #include <algorithm>
 
-// Define infinity constants for the search.
-constexpr float NEG_INF = -1000000.0f;
-constexpr float POS_INF =  1000000.0f;
+static size_t hashSize(size_t hashMB)
+{
+    const char* size = std::getenv("PERCHFISH_HASH");
+    return size ? std::strtoull(size, nullptr, 10) : hashMB;
+}
 
-Engine::Engine() : positionORM("chess.db")
+Engine::Engine(const std::string& dbPath, size_t hashMB) : transpositionTable(hashSize(hashMB)), positionORM(dbPath)
 {
-    heuristics.emplace_back(std::make_unique<Heuristic2>());
+    // PERCHFISH_NNUE names a network file to evaluate with instead of Heuristic2.
+    if (const char* networkPath = std::getenv("PERCHFISH_NNUE"))
+    {
+        auto network = std::make_shared<NNUE::Network>();
+        if (network->load(networkPath))
+            addHeuristic(std::make_unique<NNUEHeuristic>(std::move(network)));
+        else
+            std::cerr << "Failed to load NNUE network: " << networkPath << std::endl;
+    }
+    if (const char* threads = std::getenv("PERCHFISH_THREADS"))
+        setThreads(std::atoi(threads));
 }
 
 Engine::~Engine()
@@ -20,27 +35,60 @@ Engine::~Engine()
     // Smart pointers in 'heuristics' handle memory automatically.
 }
 
+void Engine::setThreads(int threads)
+{
+    std::lock_guard<std::mutex> lock(helperMutex);
+    helpers.resize(std::max(threads, 1) - 1);
+    for (auto& helper : helpers)
+        if (!helper)
+            helper = std::make_unique<Helper>();
+    threadCount = static_cast<int>(helpers.size()) + 1;
+}
+
+EvalStats Engine::getEvalStats() const
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return evalStats;
+}
+
+void Engine::addHeuristic(std::unique_ptr<Heuristic> heuristic)
+{
+    heuristics.emplace_back(std::move(heuristic));
+    evalCache.clear();
+}
+
 std::string Engine::getBestMove(const std::string& stateStr, int depth)
 {
-    // Retrieve the cached position from the database.
+    SearchLimits limits;
+    limits.depth = depth;
+    return getBestMove(stateStr, limits);
+}
+
+std::string Engine::getBestMove(const std::string& stateStr, const SearchLimits& limits)
+{
+    // Retrieve the cached position from the database. A stored move answers only a
+    // request with a depth limit no deeper than the search it came from; without a
+    // depth limit the budget's depth is unknown, so the position is searched.
     Position position = positionORM.getPosition(stateStr);
-    if (!position.fen.empty() && position.fen == stateStr && !position.best_move.empty())
+    bool stored = !position.fen.empty() && position.fen == stateStr && !position.best_move.empty();
+    if (stored && limits.depth > 0 && position.depth >= limits.depth)
     {
         std::cout << "Found position in database: " << position.best_move << std::endl;
         return position.best_move;
     }
     else
     {
-        std::cout << "Position not found in database." << std::endl;
+        std::cout << "Position not found in database at this depth." << std::endl;
     }
     
     // If not found, compute the best move.
     ChessState state(stateStr);
     ChessMove bestMove;
-    float bestScore = 0.0f;
+    Score bestScore = SCORE_DRAW;
+    int completedDepth = 0;
     
     // Get best move using alpha-beta search.
-    std::tie(bestMove, bestScore) = getBestMove_(state, depth);
+    std::tie(bestMove, bestScore) = getBestMove_(state, limits, completedDepth);
     
     std::string computedMove = bestMove.toString();
     if (computedMove.empty())
@@ -50,40 +98,163 @@ std::string Engine::getBestMove(const std::string& stateStr, int depth)
     }
     
 
-    // Cache the computed result into the database.
-    bool insertSuccess = positionORM.insertPosition({ stateStr, computedMove, bestScore });
-    if (insertSuccess)
+    // Cache the computed result into the database, replacing a shallower one.
+    Position computed{ stateStr, computedMove, bestScore, completedDepth };
+    if (!stored)
     {
-        std::cout << "Inserted new position into database: " << computedMove << std::endl;
+        if (positionORM.insertPosition(computed))
+            std::cout << "Inserted new position into database: " << computedMove << std::endl;
+        else
+            std::cerr << "Failed to insert position into database." << std::endl;
     }
-    else
+    else if (completedDepth > position.depth)
     {
-        std::cerr << "Failed to insert position into database." << std::endl;
+        if (positionORM.updatePosition(computed))
+            std::cout << "Updated position in database: " << computedMove << std::endl;
+        else
+            std::cerr << "Failed to update position in database." << std::endl;
     }
     
     return computedMove;
 }
 
-std::pair<ChessMove, float> Engine::getBestMove_(ChessState& state, int depth)
+std::pair<ChessMove, Score> Engine::getBestMove_(ChessState& state, const SearchLimits& limits, int& completedDepth)
+{
+    // Allocate the search scratch memory once, before the search starts.
+    auto stack = std::make_unique<SearchStack>();
+    auto result = search(state, limits, *stack);
+    completedDepth = stack->completedDepth;
+    return result;
+}
+
+std::pair<ChessMove, Score> Engine::search(ChessState& state, int depth, SearchStack& stack)
+{
+    SearchLimits limits;
+    limits.depth = std::max(depth, 1);
+    return search(state, limits, stack);
+}
+
+std::pair<ChessMove, Score> Engine::search(ChessState& state, const SearchLimits& limits, SearchStack& stack)
+{
+    int maxDepth = limits.depth > 0 ? std::min(limits.depth, SearchStack::MAX_PLY - 1) : SearchStack::MAX_PLY - 1;
+    std::atomic<bool> stop{false};
+
+    stack.nodeLimit = limits.nodes;
+    stack.hasDeadline = limits.movetime.count() > 0;
+    stack.deadline = std::chrono::steady_clock::now() + limits.movetime;
+    stack.sharedStop = nullptr;
+
+    // If another search is using the helpers, this one runs on the calling thread alone.
+    std::unique_lock<std::mutex> lock(helperMutex, std::try_to_lock);
+    size_t helperCount = lock.owns_lock() ? helpers.size() : 0;
+
+    // Helpers have no limits of their own; they stop with the main thread. Their
+    // copies of the root are made here, before the main thread starts moving on it.
+    for (size_t i = 0; i < helperCount; i++)
+    {
+        Helper& helper = *helpers[i];
+        helper.state.emplace(state);
+        helper.stack.nodeLimit = 0;
+        helper.stack.hasDeadline = false;
+        helper.stack.sharedStop = &stop;
+    }
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < helperCount; i++)
+    {
+        Helper& helper = *helpers[i];
+        workers.emplace_back([this, &helper, maxDepth, i]()
+        {
+            helper.result = iterate(*helper.state, helper.stack, maxDepth, static_cast<int>(i) + 1);
+        });
+    }
+
+    std::pair<ChessMove, Score> best = iterate(state, stack, maxDepth, 0);
+    stop = true;
+    for (auto& thread : workers)
+        thread.join();
+
+    // The main thread decides: the deepest completed iteration wins, its own on ties.
+    EvalStats totals = stack.evalStats;
+    for (size_t i = 0; i < helperCount; i++)
+    {
+        const Helper& helper = *helpers[i];
+        if (helper.stack.completedDepth > stack.completedDepth && helper.result.first != ChessMove())
+        {
+            best = helper.result;
+            stack.completedDepth = helper.stack.completedDepth;
+        }
+        totals.evaluations += helper.stack.evalStats.evaluations;
+        totals.lazyExits += helper.stack.evalStats.lazyExits;
+    }
+
+    std::lock_guard<std::mutex> statsLock(statsMutex);
+    evalStats.evaluations += totals.evaluations;
+    evalStats.lazyExits += totals.lazyExits;
+    return best;
+}
+
+bool Engine::searchesDepth(int thread, int depth)
 {
-    std::vector<ChessMove> legalMoves = state.getLegalMoves();
+    // Blocks of 1 to 4 depths at every phase within the block, one pattern per helper
+    static constexpr int skipSize[] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+    static constexpr int skipPhase[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+    if (thread == 0)
+        return true;
+    int pattern = (thread - 1) % 20;
+    return (depth + skipPhase[pattern]) / skipSize[pattern] % 2 == 0;
+}
+
+// One thread's iterative deepening, following its searchesDepth schedule. The last
+// depth is never skipped.
+std::pair<ChessMove, Score> Engine::iterate(ChessState& state, SearchStack& stack, int maxDepth, int thread)
+{
+    stack.nodes = 1;
+    stack.completedDepth = 0;
+    stack.evalStats = {};
+    stack.stopped = false;
+
+    MoveList& legalMoves = stack.moves[0];
+    state.generateLegalMoves(legalMoves);
     
     // If no legal moves are available, return a default move with score zero.
     if (legalMoves.empty())
     {
-        std::cerr << "No legal moves available in state." << std::endl;
-        return { ChessMove(), 0.0f };
+        if (thread == 0)
+            std::cerr << "No legal moves available in state." << std::endl;
+        return { ChessMove(), SCORE_DRAW };
     }
-    
-    float bestScore = NEG_INF;
+
+    std::pair<ChessMove, Score> best{ legalMoves[0], SCORE_DRAW };
+    for (int depth = 1; depth <= maxDepth; depth++)
+    {
+        if (depth < maxDepth && !searchesDepth(thread, depth))
+            continue;
+        auto result = searchRoot(state, stack, depth);
+        if (stack.stopped)
+            break;  // An interrupted iteration is discarded.
+        best = result;
+        stack.completedDepth = depth;
+
+        // Search the best move first in the next iteration.
+        ChessMove* position = std::find(legalMoves.begin(), legalMoves.end(), best.first);
+        std::rotate(legalMoves.begin(), position, position + 1);
+    }
+    return best;
+}
+
+std::pair<ChessMove, Score> Engine::searchRoot(ChessState& state, SearchStack& stack, int depth)
+{
+    Score bestScore = -SCORE_INFINITE;
     ChessMove bestMove;
-    
-    // Evaluate each legal move using alpha-beta search.
-    for (const auto& move : legalMoves)
+
+    // Every move after the first only has to prove it beats the best so far.
+    for (const auto& move : stack.moves[0])
     {
         state.makeMove(move);
-        float score = alphabeta(state, depth - 1, NEG_INF, POS_INF, false);
+        Score score = -alphabeta(state, stack, 1, depth - 1, -SCORE_INFINITE, -bestScore);
         state.unmakeMove(move);
+        if (stack.stopped)
+            return { bestMove, bestScore };
         
         if (score > bestScore)
         {
@@ -91,67 +262,145 @@ std::pair<ChessMove, float> Engine::getBestMove_(ChessState& state, int depth)
             bestMove = move;
         }
     }
-    
+
+    transpositionTable.store(state.getKey(), { bestMove, TranspositionTable::toStored(bestScore, 0), depth, TranspositionTable::EXACT });
     return { bestMove, bestScore };
 }
 
-float Engine::alphabeta(ChessState& state, int depth, float alpha, float beta, bool maximizingPlayer)
+// Checks the limits: node counts exactly, the clock every 1024 nodes. Nothing but the
+// main thread finishing stops the first iteration.
+bool Engine::shouldStop(SearchStack& stack) const
 {
+    if (stack.sharedStop && stack.sharedStop->load(std::memory_order_relaxed))
+        stack.stopped = true;
+    if (stack.stopped || stack.completedDepth == 0)
+        return stack.stopped;
+    if (stack.nodeLimit && stack.nodes >= stack.nodeLimit)
+        stack.stopped = true;
+    else if (stack.hasDeadline && (stack.nodes & 1023) == 0 && std::chrono::steady_clock::now() >= stack.deadline)
+        stack.stopped = true;
+    return stack.stopped;
+}
+
+// Heuristics score for white; the search scores for the side to move.
+static Score forSideToMove(const ChessState& state, Score score)
+{
+    return clampEval(state.whiteToMove ? score : -score);
+}
+
+// Negamax: every score is from the point of view of the side to move at that node.
+Score Engine::alphabeta(ChessState& state, SearchStack& stack, int ply, int depth, Score alpha, Score beta)
+{
+    stack.nodes++;
+    if (shouldStop(stack))
+        return 0;
+
     // Terminal condition: depth is zero or state is terminal.
-    if (depth == 0 || state.isTerminal())
+    if (depth == 0)
     {
-        // If it's checkmate, return a very large value adjusted by whose turn it is.
-        if (state.isCheckmate())
+        // Only non-terminal leaves are cached, so a hit also skips move generation.
+        Score score = 0;
+        if (evalCache.probe(state.getKey(), score))
+            return score;
+
+        // Classify the leaf with one move generation.
+        MoveList& legalMoves = stack.moves[ply];
+        ChessState::NodeStatus status = state.nodeStatus(legalMoves);
+
+        // Being mated scores worse the sooner it happens.
+        if (status == ChessState::CHECKMATE)
         {
-            return maximizingPlayer ? -1000000.0f : 1000000.0f;
+            return matedIn(ply);
         }
         
-        if (state.isStalemate())
+        if (status == ChessState::STALEMATE)
         {
-            return 0.0f;
+            return SCORE_DRAW;
         }
 
-        // Evaluate the state using the heuristics.
-        float score = 0.0f;
-        for (const auto& heuristic : heuristics)
+        stack.evalStats.evaluations++;
+        if (heuristics.empty())
         {
-            score += (*heuristic)(state);
+            // Cheap terms first. If they are so far outside the window that the
+            // expensive terms cannot bring the score back, return the bound instead;
+            // a bound is not an exact score, so it is not cached.
+            Score cheap = evaluation.cheap(state);
+            Score bound = forSideToMove(state, cheap);
+            if (bound + lazyMargin <= alpha || bound - lazyMargin >= beta)
+            {
+                stack.evalStats.lazyExits++;
+                return bound + lazyMargin <= alpha ? bound + lazyMargin : bound - lazyMargin;
+            }
+            score = forSideToMove(state, cheap + evaluation.expensive(state));
         }
-
+        else
+        {
+            for (const auto& heuristic : heuristics)
+            {
+                score += (*heuristic)(state);
+            }
+            score = forSideToMove(state, score);
+        }
+        evalCache.store(state.getKey(), score);
 
         return score;
     }
     
-    std::vector<ChessMove> legalMoves = state.getLegalMoves();
-    
-    if (maximizingPlayer)
+    // A result from an earlier search at least as deep ends the node if its bound
+    // settles the score for this window; otherwise its move is searched first.
+    uint64_t key = state.getKey();
+    TranspositionTable::Entry entry;
+    ChessMove hashMove;
+    if (transpositionTable.probe(key, entry))
     {
-        float maxEval = -1000000.0f;
-        for (const ChessMove& move : legalMoves)
+        hashMove = entry.move;
+        Score score = TranspositionTable::fromStored(entry.score, ply);
+        if (entry.depth >= depth && (entry.bound == TranspositionTable::EXACT ||
+            (entry.bound == TranspositionTable::LOWER_BOUND && score >= beta) ||
+            (entry.bound == TranspositionTable::UPPER_BOUND && score <= alpha)))
         {
-            state.makeMove(move);
-            float eval = alphabeta(state, depth - 1, alpha, beta, false);
-            state.unmakeMove(move);
-            maxEval = std::max(maxEval, eval);
-            alpha = std::max(alpha, eval);
-            if (beta <= alpha)
-                break;  // Beta cutoff.
+            transpositionTable.recordCutoff();
+            return score;
         }
-        return maxEval;
     }
-    else
+
+    // Moves are produced lazily, so a cutoff skips generating the remaining stages.
+    MovePicker picker(state, stack.moves[ply], hashMove);
+    ChessMove move;
+    int movesSearched = 0;
+    Score bestScore = -SCORE_INFINITE;
+    ChessMove bestMove;
+    Score originalAlpha = alpha;
+    
+    while (picker.next(move))
     {
-        float minEval = 1000000.0f;
-        for (const ChessMove& move : legalMoves)
+        movesSearched++;
+        state.makeMove(move);
+        Score score = -alphabeta(state, stack, ply + 1, depth - 1, -beta, -alpha);
+        state.unmakeMove(move);
+        if (stack.stopped)
+            return 0;  // The result is discarded, and nothing partial is stored.
+        if (score > bestScore)
         {
-            state.makeMove(move);
-            float eval = alphabeta(state, depth - 1, alpha, beta, true);
-            state.unmakeMove(move);
-            minEval = std::min(minEval, eval);
-            beta = std::min(beta, eval);
-            if (beta <= alpha)
-                break;  // Alpha cutoff.
+            bestScore = score;
+            bestMove = move;
         }
-        return minEval;
+        alpha = std::max(alpha, score);
+        if (alpha >= beta)
+            break;  // Beta cutoff.
+    }
+
+    TranspositionTable::Bound bound = TranspositionTable::EXACT;
+    if (movesSearched == 0)
+        bestScore = state.isInCheck(state.whiteToMove) ? matedIn(ply) : SCORE_DRAW;
+    else if (bestScore <= originalAlpha)
+    {
+        // No move stood out, so keep the previous hash move.
+        bound = TranspositionTable::UPPER_BOUND;
+        bestMove = hashMove;
     }
+    else if (bestScore >= beta)
+        bound = TranspositionTable::LOWER_BOUND;
+    transpositionTable.store(key, { bestMove, TranspositionTable::toStored(bestScore, ply), depth, bound });
+    return bestScore;
 }
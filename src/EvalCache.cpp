@@ -0,0 +1,27 @@
+#include "EvalCache.hpp"
+
+
+// The top bit keeps a stored score nonzero, so that it validates.
+bool EvalCache::probe(uint64_t key, Score& score) const
+{
+    probeCount.add();
+    uint64_t data;
+    if (!entries[key].read(key, data))
+        return false;
+    score = static_cast<Score>(static_cast<uint32_t>(data));
+    hitCount.add();
+    return true;
+}
+
+void EvalCache::store(uint64_t key, Score score)
+{
+    entries[key].write(key, (uint64_t(1) << 63) | static_cast<uint32_t>(score));
+}
+
+void EvalCache::clear()
+{
+    for (size_t i = 0; i < entries.size(); i++)
+        entries[i].clear();
+    probeCount.reset();
+    hitCount.reset();
+}
@@ -0,0 +1,93 @@
+#include "MovePicker.hpp"
+#include <utility>
+
+// Piece values used for capture ordering, indexed by PieceType.
+static constexpr int orderingValues[6] = { 1, 3, 3, 5, 9, 100 };
+// Promotion codes (0: Queen, 1: Rook, 2: Knight, 3: Bishop) as piece types.
+static constexpr int promotionTypes[4] = { QUEEN, ROOK, KNIGHT, BISHOP };
+
+
+MovePicker::MovePicker(ChessState& state, MoveList& moves, ChessMove hashMove)
+    : state(state), moves(moves), masks(state.computeMoveGenMasks()), hashMove(hashMove),
+      stage(hashMove == ChessMove() ? GENERATE_CAPTURES : HASH_MOVE)
+{
+}
+
+bool MovePicker::next(ChessMove& move)
+{
+    switch (stage)
+    {
+        case HASH_MOVE:
+            stage = GENERATE_CAPTURES;
+            if (state.isPseudoLegal(hashMove) && state.isLegal(hashMove, masks))
+            {
+                move = hashMove;
+                return true;
+            }
+            [[fallthrough]];
+
+        case GENERATE_CAPTURES:
+            state.generateMoves(ChessState::CAPTURES, masks, moves);
+            scoreCaptures();
+            index = 0;
+            stage = CAPTURES;
+            [[fallthrough]];
+
+        case CAPTURES:
+            while (index < moves.size())
+            {
+                selectBest();
+                move = moves[index++];
+                if (move != hashMove && state.isLegal(move, masks))
+                    return true;
+            }
+            stage = GENERATE_QUIETS;
+            [[fallthrough]];
+
+        case GENERATE_QUIETS:
+            state.generateMoves(ChessState::QUIETS, masks, moves);
+            index = 0;
+            stage = QUIETS;
+            [[fallthrough]];
+
+        case QUIETS:
+            while (index < moves.size())
+            {
+                move = moves[index++];
+                if (move != hashMove && state.isLegal(move, masks))
+                    return true;
+            }
+            stage = DONE;
+            [[fallthrough]];
+
+        case DONE:
+            return false;
+    }
+    return false;
+}
+
+void MovePicker::scoreCaptures()
+{
+    // Most valuable victim first, least valuable attacker as tie-break.
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        const ChessMove& move = moves[i];
+        int victim = pieceIndex(state.pieceOn(move.toSquare()));
+        int attacker = pieceIndex(state.pieceOn(move.fromSquare())) % 6;
+        int score = (victim == NO_PIECE ? orderingValues[PAWN] : orderingValues[victim % 6]) * 16 - orderingValues[attacker];
+        if (move.getFlag() == ChessMove::PROMOTION)
+            score += orderingValues[promotionTypes[move.getPromotion()]] * 16;
+        scores[i] = score;
+    }
+}
+
+void MovePicker::selectBest()
+{
+    // Partial selection sort: only the moves actually handed out get sorted.
+    size_t best = index;
+    for (size_t i = index + 1; i < moves.size(); i++)
+        if (scores[i] > scores[best])
+            best = i;
+    std::swap(moves[best], moves[index]);
+    std::swap(scores[best], scores[index]);
+}
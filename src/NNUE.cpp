@@ -0,0 +1,117 @@
+#include "NNUE.hpp"
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+namespace NNUE
+{
+    bool Network::load(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        char magic[4];
+        uint32_t version = 0, hidden = 0;
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        file.read(reinterpret_cast<char*>(&hidden), sizeof(hidden));
+        if (!file || std::memcmp(magic, "PFNN", 4) != 0 || version != 1 || hidden != HIDDEN)
+            return false;
+
+        std::vector<int8_t> output(2 * HIDDEN);
+        file.read(reinterpret_cast<char*>(featureWeights), sizeof(featureWeights));
+        file.read(reinterpret_cast<char*>(featureBiases), sizeof(featureBiases));
+        file.read(reinterpret_cast<char*>(output.data()), static_cast<std::streamsize>(output.size()));
+        file.read(reinterpret_cast<char*>(&outputBias), sizeof(outputBias));
+        if (!file)
+            return false;
+
+        for (int i = 0; i < 2 * HIDDEN; i++)
+            outputWeights[i] = output[i];
+        return true;
+    }
+
+    void Network::refresh(Accumulator& accumulator, const Bitboard (&pieces)[12]) const
+    {
+        for (int perspective = 0; perspective < 2; perspective++)
+            std::memcpy(accumulator.values[perspective], featureBiases, sizeof(featureBiases));
+        for (int piece = 0; piece < 12; piece++)
+            for (Bitboard bb = pieces[piece]; bb; )
+                addPiece(accumulator, piece, popLsb(bb));
+    }
+
+    // Adds (sign = 1) or subtracts (sign = -1) one weight row from an accumulator
+    // half. int16 arithmetic wraps, so a removal exactly undoes an addition.
+    template <int Sign>
+    static void updateRow(int16_t* values, const int16_t* row)
+    {
+#if defined(__AVX2__)
+        for (int i = 0; i < HIDDEN; i += 16)
+        {
+            __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(row + i));
+            v = Sign > 0 ? _mm256_add_epi16(v, w) : _mm256_sub_epi16(v, w);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(values + i), v);
+        }
+#else
+        for (int i = 0; i < HIDDEN; i++)
+            values[i] = static_cast<int16_t>(values[i] + Sign * row[i]);
+#endif
+    }
+
+    void Network::addPiece(Accumulator& accumulator, int piece, int square) const
+    {
+        for (int perspective = 0; perspective < 2; perspective++)
+            updateRow<1>(accumulator.values[perspective], featureWeights[featureIndex(perspective, piece, square)]);
+    }
+
+    void Network::removePiece(Accumulator& accumulator, int piece, int square) const
+    {
+        for (int perspective = 0; perspective < 2; perspective++)
+            updateRow<-1>(accumulator.values[perspective], featureWeights[featureIndex(perspective, piece, square)]);
+    }
+
+    // Sum of clippedReLU(values) * weights over one accumulator half.
+    static int32_t clippedDot(const int16_t* values, const int16_t* weights)
+    {
+#if defined(__AVX2__)
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i ceiling = _mm256_set1_epi16(QA);
+        __m256i sum = zero;
+        for (int i = 0; i < HIDDEN; i += 16)
+        {
+            __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i));
+            v = _mm256_min_epi16(_mm256_max_epi16(v, zero), ceiling);
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, w));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(half);
+#else
+        int32_t sum = 0;
+        for (int i = 0; i < HIDDEN; i++)
+        {
+            int32_t v = values[i] < 0 ? 0 : (values[i] > QA ? QA : values[i]);
+            sum += v * weights[i];
+        }
+        return sum;
+#endif
+    }
+
+    int Network::evaluate(const Accumulator& accumulator, bool whiteToMove) const
+    {
+        int us = whiteToMove ? 0 : 1;
+        int64_t output = outputBias
+                       + clippedDot(accumulator.values[us], outputWeights)
+                       + clippedDot(accumulator.values[us ^ 1], outputWeights + HIDDEN);
+        return static_cast<int>(output * SCALE / (QA * QB));
+    }
+}
@@ -0,0 +1,101 @@
+#include "PawnTable.hpp"
+#include "EvalTables.hpp"
+
+
+static constexpr Bitboard fileA = 0x0101010101010101ULL;
+
+// Files next to a file, and squares ahead of a row from one side's point of view
+// (white pawns advance towards row 0).
+static constexpr Bitboard adjacentFiles(int col)
+{
+    return (col > 0 ? fileA << (col - 1) : 0) | (col < 7 ? fileA << (col + 1) : 0);
+}
+
+template <Color Us>
+static constexpr Bitboard rowsAhead(int row)
+{
+    if constexpr (Us == WHITE)
+        return squareBit(row * 8) - 1;
+    else
+        return row < 7 ? ~(squareBit((row + 1) * 8) - 1) : 0;
+}
+
+template <Color Us>
+static PawnTable::Terms countSide(Bitboard own, Bitboard enemy)
+{
+    PawnTable::Terms terms;
+    for (int col = 0; col < 8; col++)
+    {
+        int count = popCount(own & (fileA << col));
+        if (count == 0)
+            continue;
+        if (count > 1)
+            terms.doubled += count - 1;
+        if (!(own & adjacentFiles(col)))
+            terms.isolated += count;
+    }
+
+    for (Bitboard bb = own; bb; )
+    {
+        int square = popLsb(bb);
+        int row = rowOf(square), col = colOf(square);
+        Bitboard span = rowsAhead<Us>(row) & ((fileA << col) | adjacentFiles(col));
+        if (enemy & span)
+            continue;
+        int rank = Us == WHITE ? 7 - row : row;
+        terms.passed[rank]++;
+    }
+    return terms;
+}
+
+PawnTable::Terms PawnTable::countTerms(Color us, Bitboard own, Bitboard enemy)
+{
+    return us == WHITE ? countSide<WHITE>(own, enemy) : countSide<BLACK>(own, enemy);
+}
+
+static void addTerms(const PawnTable::Terms& terms, int sign, int& mg, int& eg)
+{
+    mg += sign * (EvalTables::doubledPawnMg * terms.doubled + EvalTables::isolatedPawnMg * terms.isolated);
+    eg += sign * (EvalTables::doubledPawnEg * terms.doubled + EvalTables::isolatedPawnEg * terms.isolated);
+    for (int rank = 0; rank < 8; rank++)
+    {
+        mg += sign * EvalTables::passedPawnMg[rank] * terms.passed[rank];
+        eg += sign * EvalTables::passedPawnEg[rank] * terms.passed[rank];
+    }
+}
+
+PawnTable::Entry PawnTable::evaluate(Bitboard whitePawns, Bitboard blackPawns)
+{
+    int mg = 0, eg = 0;
+    addTerms(countSide<WHITE>(whitePawns, blackPawns), 1, mg, eg);
+    addTerms(countSide<BLACK>(blackPawns, whitePawns), -1, mg, eg);
+    return { 0, static_cast<int16_t>(mg), static_cast<int16_t>(eg) };
+}
+
+const PawnTable::Entry& PawnTable::probe(const ChessState& state)
+{
+    uint64_t key = state.getPawnKey();
+    Entry& entry = entries[key & (SIZE - 1)];
+    probes++;
+    if (entry.key == key)
+    {
+        hits++;
+        return entry;
+    }
+    entry = evaluate(state.pieces[WHITE_PAWN], state.pieces[BLACK_PAWN]);
+    entry.key = key;
+    return entry;
+}
+
+void PawnTable::clear()
+{
+    for (Entry& entry : entries)
+        entry = {};
+    probes = hits = 0;
+}
+
+PawnTable& PawnTable::forThread()
+{
+    thread_local PawnTable table;
+    return table;
+}
@@ -0,0 +1,98 @@
+#include "Perft.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <thread>
+
+
+// Stored depths are at least 2, so written data is never zero.
+bool PerftTable::probe(uint64_t key, int depth, uint64_t& nodes) const
+{
+    uint64_t data;
+    if (!entries[key].read(key, data) || static_cast<int>(data & 0xFF) != depth)
+        return false;
+    nodes = data >> 8;
+    return true;
+}
+
+void PerftTable::store(uint64_t key, int depth, uint64_t nodes)
+{
+    entries[key].write(key, (nodes << 8) | static_cast<uint64_t>(depth));
+}
+
+static uint64_t hashedPerft(ChessState& state, int depth, PerftTable& table)
+{
+    if (depth <= 1)
+        return state.perft(depth);
+
+    uint64_t key = state.getKey();
+    uint64_t nodes = 0;
+    if (table.probe(key, depth, nodes))
+        return nodes;
+
+    MoveList legalMoves;
+    state.generateLegalMoves(legalMoves);
+    for (const ChessMove& move : legalMoves)
+    {
+        state.makeMove(move);
+        nodes += hashedPerft(state, depth - 1, table);
+        state.unmakeMove(move);
+    }
+
+    table.store(key, depth, nodes);
+    return nodes;
+}
+
+PerftResult runPerft(const ChessState& state, int depth, const PerftOptions& options)
+{
+    auto start = std::chrono::steady_clock::now();
+    PerftResult result;
+
+    ChessState root = state;
+    MoveList rootMoves;
+    root.generateLegalMoves(rootMoves);
+
+    std::unique_ptr<PerftTable> table;
+    if (options.hashMB > 0)
+        table = std::make_unique<PerftTable>(options.hashMB);
+
+    if (depth <= 0)
+    {
+        result.nodes = 1;
+    }
+    else
+    {
+        // Root moves are handed out to the workers one at a time.
+        std::vector<uint64_t> counts(rootMoves.size(), 0);
+        std::atomic<size_t> next{0};
+        auto worker = [&]()
+        {
+            ChessState local = root;
+            for (size_t i = next++; i < rootMoves.size(); i = next++)
+            {
+                local.makeMove(rootMoves[i]);
+                counts[i] = table ? hashedPerft(local, depth - 1, *table) : local.perft(depth - 1);
+                local.unmakeMove(rootMoves[i]);
+            }
+        };
+
+        int threads = std::clamp(options.threads, 1, static_cast<int>(std::max<size_t>(1, rootMoves.size())));
+        std::vector<std::thread> workers;
+        for (int i = 1; i < threads; i++)
+            workers.emplace_back(worker);
+        worker();
+        for (auto& thread : workers)
+            thread.join();
+
+        for (size_t i = 0; i < rootMoves.size(); i++)
+        {
+            result.nodes += counts[i];
+            if (options.divide)
+                result.divide.emplace_back(rootMoves[i], counts[i]);
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
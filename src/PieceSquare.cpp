@@ -0,0 +1,92 @@
+#include "PieceSquare.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+namespace PieceSquare
+{
+    // Piece characters are told apart without branches by a 4-bit hash of the
+    // lowercased character: p 7, n 8, b 4, r 5, q 6, k 13 and the empty '0' 3.
+    // Case (bit 0x20) then selects the color; '0' has the bit set like black pieces.
+    static constexpr int8_t typeByHash[16] = { 6, 6, 6, 6, BISHOP, ROOK, QUEEN, PAWN, KNIGHT, 6, 6, 6, 6, KING, 6, 6 };
+    static constexpr int8_t phaseByHash[16] = { 0, 0, 0, 0, 1, 2, 4, 0, 1, 0, 0, 0, 0, 0, 0, 0 };
+
+    static_assert(phaseByHash[4] == EvalTables::phaseWeight[BISHOP] && phaseByHash[5] == EvalTables::phaseWeight[ROOK] &&
+                  phaseByHash[6] == EvalTables::phaseWeight[QUEEN] && phaseByHash[8] == EvalTables::phaseWeight[KNIGHT],
+                  "phaseByHash must follow EvalTables::phaseWeight");
+
+    constexpr int characterHash(char c)
+    {
+        int lower = c | 0x20;
+        return (lower ^ (lower >> 4)) & 0xF;
+    }
+
+    Scores evaluateScalar(const char* board)
+    {
+        Scores scores{0, 0, 0};
+        for (int square = 0; square < 64; square++)
+        {
+            int hash = characterHash(board[square]);
+            // Black pieces and empty squares (index 12, a zero row) have bit 0x20 set.
+            int index = typeByHash[hash] + ((board[square] & 0x20) ? 6 : 0);
+            scores.mg += table.mg[index][square];
+            scores.eg += table.eg[index][square];
+            scores.phase += phaseByHash[hash];
+        }
+        return scores;
+    }
+
+#if defined(__AVX2__)
+    static int horizontalSum(__m256i v)
+    {
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(sum);
+    }
+
+    Scores evaluate(const char* board)
+    {
+        const __m256i typeLut = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(typeByHash)));
+        const __m256i phaseLut = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(phaseByHash)));
+        const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+        const __m256i caseBit = _mm256_set1_epi8(0x20);
+        const __m256i six = _mm256_set1_epi8(6);
+
+        __m256i mg = _mm256_setzero_si256(), eg = _mm256_setzero_si256(), phase = _mm256_setzero_si256();
+        for (int half = 0; half < 64; half += 32)
+        {
+            __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(board + half));
+            __m256i lower = _mm256_or_si256(chars, caseBit);
+            __m256i hash = _mm256_and_si256(_mm256_xor_si256(lower, _mm256_srli_epi16(lower, 4)), lowNibble);
+
+            // Table row per square: piece type, plus 6 for black pieces and empty squares.
+            __m256i black = _mm256_cmpeq_epi8(_mm256_and_si256(chars, caseBit), caseBit);
+            __m256i index = _mm256_add_epi8(_mm256_shuffle_epi8(typeLut, hash), _mm256_and_si256(black, six));
+            phase = _mm256_add_epi64(phase, _mm256_sad_epu8(_mm256_shuffle_epi8(phaseLut, hash), _mm256_setzero_si256()));
+
+            // Gather table[index][square] eight squares at a time.
+            alignas(32) uint8_t rows[32];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(rows), index);
+            for (int group = 0; group < 32; group += 8)
+            {
+                __m256i row = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(rows + group)));
+                __m256i square = _mm256_add_epi32(_mm256_set1_epi32(half + group), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+                __m256i offset = _mm256_add_epi32(_mm256_slli_epi32(row, 6), square);
+                mg = _mm256_add_epi32(mg, _mm256_i32gather_epi32(&table.mg[0][0], offset, 4));
+                eg = _mm256_add_epi32(eg, _mm256_i32gather_epi32(&table.eg[0][0], offset, 4));
+            }
+        }
+
+        // The byte sums sit in the low 32 bits of each 64-bit lane.
+        return { horizontalSum(mg), horizontalSum(eg), horizontalSum(phase) };
+    }
+#else
+    Scores evaluate(const char* board)
+    {
+        return evaluateScalar(board);
+    }
+#endif
+}
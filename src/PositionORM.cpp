@@ -23,7 +23,8 @@ bool PositionORM::initialize() {
     std::string sql = "CREATE TABLE IF NOT EXISTS POSITION ("
                       "NAME CHAR(71) NOT NULL PRIMARY KEY, "
                       "BEST_MOVE CHAR(5) NOT NULL, "
-                      "SCORE INT NOT NULL"
+                      "SCORE INT NOT NULL, "
+                      "DEPTH INT NOT NULL DEFAULT 0"
                       ");";
     char* errMsg = nullptr;
     int rc = sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errMsg);
@@ -32,11 +33,24 @@ bool PositionORM::initialize() {
         sqlite3_free(errMsg);
         return false;
     }
+
+    // Databases created before the DEPTH column get it with depth 0 (unknown) rows.
+    sqlite3_stmt* stmt;
+    bool hasDepth = sqlite3_prepare_v2(db, "SELECT DEPTH FROM POSITION LIMIT 0;", -1, &stmt, nullptr) == SQLITE_OK;
+    sqlite3_finalize(stmt);
+    if (!hasDepth) {
+        rc = sqlite3_exec(db, "ALTER TABLE POSITION ADD COLUMN DEPTH INT NOT NULL DEFAULT 0;", nullptr, nullptr, &errMsg);
+        if (rc != SQLITE_OK) {
+            std::cerr << "SQL error during table migration: " << errMsg << std::endl;
+            sqlite3_free(errMsg);
+            return false;
+        }
+    }
     return true;
 }
 
 bool PositionORM::insertPosition(const Position& pos) {
-    std::string sql = "INSERT INTO POSITION (NAME, BEST_MOVE, SCORE) VALUES (?, ?, ?);";
+    std::string sql = "INSERT INTO POSITION (NAME, BEST_MOVE, SCORE, DEPTH) VALUES (?, ?, ?, ?);";
     sqlite3_stmt* stmt;
 
     if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
@@ -46,7 +60,8 @@ bool PositionORM::insertPosition(const Position& pos) {
 
     sqlite3_bind_text(stmt, 1, pos.fen.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 2, pos.best_move.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 3, pos.score);
+    sqlite3_bind_int(stmt, 3, pos.score);
+    sqlite3_bind_int(stmt, 4, pos.depth);
 
     bool success = (sqlite3_step(stmt) == SQLITE_DONE);
     if (!success) {
@@ -57,19 +72,19 @@ bool PositionORM::insertPosition(const Position& pos) {
 }
 
 Position PositionORM::getPosition(const std::string& name) {
-    std::string sql = "SELECT BEST_MOVE, SCORE FROM POSITION WHERE NAME = ?;";
+    std::string sql = "SELECT BEST_MOVE, SCORE, DEPTH FROM POSITION WHERE NAME = ?;";
     sqlite3_stmt* stmt;
-    Position pos{name, "", 0.0f};
+    Position pos{name, "", 0};
 
     if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
         sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_STATIC);
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             const char* bestMove = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            double score = sqlite3_column_double(stmt, 1);
             if (bestMove) {
                 pos.best_move = std::string(bestMove);
             }
-            pos.score = static_cast<float>(score);
+            pos.score = sqlite3_column_int(stmt, 1);
+            pos.depth = sqlite3_column_int(stmt, 2);
         }
     } else {
         std::cerr << "Failed to prepare getPosition statement: " << sqlite3_errmsg(db) << std::endl;
@@ -79,7 +94,7 @@ Position PositionORM::getPosition(const std::string& name) {
 }
 
 bool PositionORM::updatePosition(const Position& pos) {
-    std::string sql = "UPDATE POSITION SET BEST_MOVE = ?, SCORE = ? WHERE NAME = ?;";
+    std::string sql = "UPDATE POSITION SET BEST_MOVE = ?, SCORE = ?, DEPTH = ? WHERE NAME = ?;";
     sqlite3_stmt* stmt;
 
     if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
@@ -87,8 +102,9 @@ bool PositionORM::updatePosition(const Position& pos) {
     }
 
     sqlite3_bind_text(stmt, 1, pos.best_move.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 2, pos.score);
-    sqlite3_bind_text(stmt, 3, pos.fen.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, pos.score);
+    sqlite3_bind_int(stmt, 3, pos.depth);
+    sqlite3_bind_text(stmt, 4, pos.fen.c_str(), -1, SQLITE_STATIC);
 
     bool success = (sqlite3_step(stmt) == SQLITE_DONE);
     sqlite3_finalize(stmt);
@@ -0,0 +1,92 @@
+#include "TranspositionTable.hpp"
+#include <algorithm>
+
+
+// Slot data layout:
+//   bits  0-15  move
+//   bits 16-31  score (int16)
+//   bits 32-39  depth
+//   bits 40-41  bound
+//   bit  63     set, so that written data is never zero
+static uint64_t pack(const TranspositionTable::Entry& entry)
+{
+    return static_cast<uint64_t>(entry.move.raw())
+         | static_cast<uint64_t>(static_cast<uint16_t>(entry.score)) << 16
+         | static_cast<uint64_t>(entry.depth & 0xFF) << 32
+         | static_cast<uint64_t>(entry.bound) << 40
+         | uint64_t(1) << 63;
+}
+
+static TranspositionTable::Entry unpack(uint64_t data)
+{
+    TranspositionTable::Entry entry;
+    entry.move = ChessMove::fromRaw(static_cast<uint16_t>(data));
+    entry.score = static_cast<int16_t>(data >> 16);
+    entry.depth = static_cast<int>((data >> 32) & 0xFF);
+    entry.bound = static_cast<TranspositionTable::Bound>((data >> 40) & 3);
+    return entry;
+}
+
+static int storedDepth(uint64_t data)
+{
+    return static_cast<int>((data >> 32) & 0xFF);
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry& entry) const
+{
+    probeCount.add();
+    const Bucket& bucket = buckets[key];
+    uint64_t data;
+    if (!bucket.depthPreferred.read(key, data) && !bucket.alwaysReplace.read(key, data))
+        return false;
+    entry = unpack(data);
+    hitCount.add();
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, const Entry& entry)
+{
+    Bucket& bucket = buckets[key];
+
+    // The depth-preferred slot keeps the deepest search unless it holds this position;
+    // empty slots read as depth 0.
+    uint64_t existing;
+    bool samePosition = bucket.depthPreferred.read(key, existing);
+    LocklessSlot& slot = samePosition || entry.depth >= storedDepth(bucket.depthPreferred.peek())
+        ? bucket.depthPreferred : bucket.alwaysReplace;
+
+    if (slot.peek() != 0 && !slot.read(key, existing))
+        collisionCount.add();
+    slot.write(key, pack(entry));
+}
+
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i < buckets.size(); i++)
+    {
+        buckets[i].depthPreferred.clear();
+        buckets[i].alwaysReplace.clear();
+    }
+    probeCount.reset();
+    hitCount.reset();
+    cutoffCount.reset();
+    collisionCount.reset();
+}
+
+Score TranspositionTable::toStored(Score score, int ply)
+{
+    if (score > SCORE_MATE_BOUND)
+        return score + ply;
+    if (score < -SCORE_MATE_BOUND)
+        return score - ply;
+    return score;
+}
+
+Score TranspositionTable::fromStored(Score score, int ply)
+{
+    if (score > SCORE_MATE_BOUND)
+        return score - ply;
+    if (score < -SCORE_MATE_BOUND)
+        return score + ply;
+    return score;
+}
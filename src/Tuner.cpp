@@ -0,0 +1,469 @@
+#include "Tuner.hpp"
+#include "EvalTables.hpp"
+#include "PawnTable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace Tuner
+{
+    Parameters defaultParameters()
+    {
+        Parameters parameters{};
+        for (int type = PAWN; type <= KING; type++)
+        {
+            parameters[MG_VALUE + type] = EvalTables::mgValue[type];
+            parameters[EG_VALUE + type] = EvalTables::egValue[type];
+            for (int square = 0; square < 64; square++)
+            {
+                parameters[MG_TABLE + type * 64 + square] = EvalTables::mgTable[type][square];
+                parameters[EG_TABLE + type * 64 + square] = EvalTables::egTable[type][square];
+            }
+        }
+        parameters[DOUBLED_MG] = EvalTables::doubledPawnMg;
+        parameters[DOUBLED_EG] = EvalTables::doubledPawnEg;
+        parameters[ISOLATED_MG] = EvalTables::isolatedPawnMg;
+        parameters[ISOLATED_EG] = EvalTables::isolatedPawnEg;
+        for (int rank = 0; rank < 8; rank++)
+        {
+            parameters[PASSED_MG + rank] = EvalTables::passedPawnMg[rank];
+            parameters[PASSED_EG + rank] = EvalTables::passedPawnEg[rank];
+        }
+        parameters[MOBILITY] = EvalTables::mobilityWeight;
+        return parameters;
+    }
+
+    Position extract(const ChessState& state, float result)
+    {
+        Position position{};
+        for (int piece = WHITE_PAWN; piece <= BLACK_KING; piece++)
+            for (Bitboard bb = state.pieces[piece]; bb; )
+            {
+                position.pieces[position.pieceCount] = static_cast<uint8_t>(piece);
+                position.squares[position.pieceCount] = static_cast<uint8_t>(popLsb(bb));
+                position.pieceCount++;
+            }
+        position.phase = static_cast<uint8_t>(std::min(state.phase, EvalTables::MAX_PHASE));
+
+        Bitboard whitePawns = state.pieces[WHITE_PAWN], blackPawns = state.pieces[BLACK_PAWN];
+        PawnTable::Terms white = PawnTable::countTerms(WHITE, whitePawns, blackPawns);
+        PawnTable::Terms black = PawnTable::countTerms(BLACK, blackPawns, whitePawns);
+        position.doubled = static_cast<int8_t>(white.doubled - black.doubled);
+        position.isolated = static_cast<int8_t>(white.isolated - black.isolated);
+        for (int rank = 0; rank < 8; rank++)
+            position.passed[rank] = static_cast<int8_t>(white.passed[rank] - black.passed[rank]);
+
+        position.mobility = static_cast<int16_t>(state.mobility(WHITE) - state.mobility(BLACK));
+        position.result = result;
+        return position;
+    }
+
+    // Converts the board, side and castling fields of a FEN to a state string.
+    static bool fenToState(std::string_view board, std::string_view side, std::string_view castling, std::string& state)
+    {
+        state.clear();
+        for (char c : board)
+        {
+            if (c == '/')
+                continue;
+            if (c >= '1' && c <= '8')
+                state.append(c - '0', '0');
+            else
+                state.push_back(c);
+        }
+        if (state.size() != 64 || (side != "w" && side != "b"))
+            return false;
+
+        auto missing = [&](char right) { return castling.find(right) == std::string_view::npos ? '1' : '0'; };
+        state.push_back(side == "w" ? '1' : '0');
+        state.push_back(missing('K') == '1' && missing('Q') == '1' ? '1' : '0');
+        state.push_back(missing('k') == '1' && missing('q') == '1' ? '1' : '0');
+        state.push_back(missing('Q'));
+        state.push_back(missing('K'));
+        state.push_back(missing('q'));
+        state.push_back(missing('k'));
+        return true;
+    }
+
+    static bool parseResult(std::string_view token, float& result)
+    {
+        // Strip EPD/PGN decorations such as c9 "1-0"; or [0.5]
+        while (!token.empty() && (token.front() == '"' || token.front() == '['))
+            token.remove_prefix(1);
+        while (!token.empty() && (token.back() == '"' || token.back() == ']' || token.back() == ';'))
+            token.remove_suffix(1);
+
+        if (token == "1-0")
+            result = 1.0f;
+        else if (token == "0-1")
+            result = 0.0f;
+        else if (token == "1/2-1/2")
+            result = 0.5f;
+        else if (token.find('.') != std::string_view::npos)
+        {
+            char* end = nullptr;
+            std::string text(token);
+            double value = std::strtod(text.c_str(), &end);
+            if (end != text.c_str() + text.size() || value < 0.0 || value > 1.0)
+                return false;
+            result = static_cast<float>(value);
+        }
+        else
+            return false;
+        return true;
+    }
+
+    bool parseLine(std::string_view line, Position& position)
+    {
+        std::vector<std::string_view> tokens;
+        for (size_t begin = 0; begin < line.size(); )
+        {
+            size_t end = line.find_first_of(" \t\r\n", begin);
+            if (end == std::string_view::npos)
+                end = line.size();
+            if (end > begin)
+                tokens.push_back(line.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        if (tokens.size() < 2)
+            return false;
+
+        std::string state;
+        size_t fields;
+        if (tokens[0].find('/') != std::string_view::npos)
+        {
+            if (tokens.size() < 4 || !fenToState(tokens[0], tokens[1], tokens[2], state))
+                return false;
+            fields = 3;
+        }
+        else
+        {
+            state = tokens[0];
+            fields = 1;
+        }
+
+        // The last result-like token wins, after any EPD operations.
+        float result = -1.0f;
+        for (size_t i = fields; i < tokens.size(); i++)
+            parseResult(tokens[i], result);
+        if (result < 0.0f)
+            return false;
+
+        try
+        {
+            ChessState chessState(state);
+            if (popCount(chessState.allPieces) > 32)
+                return false;
+            position = extract(chessState, result);
+        }
+        catch (const std::invalid_argument&)
+        {
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<Position> loadPositions(const std::string& path, int threads, size_t& skipped)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open " + path);
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("Cannot stat " + path);
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        skipped = 0;
+        if (size == 0)
+        {
+            close(fd);
+            return {};
+        }
+
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED)
+            throw std::runtime_error("Cannot map " + path);
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        std::string_view data(static_cast<const char*>(mapping), size);
+
+        // Each thread parses a slice of whole lines into its own vector.
+        threads = std::max(1, threads);
+        std::vector<size_t> bounds(threads + 1, size);
+        bounds[0] = 0;
+        for (int i = 1; i < threads; i++)
+        {
+            size_t newline = data.find('\n', std::max(bounds[i - 1], size * i / threads));
+            bounds[i] = newline == std::string_view::npos ? size : newline + 1;
+        }
+
+        std::vector<std::vector<Position>> parsed(threads);
+        std::vector<size_t> failed(threads, 0);
+        auto worker = [&](int index)
+        {
+            for (size_t begin = bounds[index]; begin < bounds[index + 1]; )
+            {
+                size_t end = std::min(data.find('\n', begin), bounds[index + 1]);
+                std::string_view line = data.substr(begin, end - begin);
+                bool blank = line.find_first_not_of(" \t\r") == std::string_view::npos;
+                Position position;
+                if (!blank && parseLine(line, position))
+                    parsed[index].push_back(position);
+                else if (!blank)
+                    failed[index]++;
+                begin = end + 1;
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int i = 1; i < threads; i++)
+            workers.emplace_back(worker, i);
+        worker(0);
+        for (auto& thread : workers)
+            thread.join();
+        munmap(mapping, size);
+
+        std::vector<Position> positions;
+        size_t total = 0;
+        for (const auto& part : parsed)
+            total += part.size();
+        positions.reserve(total);
+        for (int i = 0; i < threads; i++)
+        {
+            positions.insert(positions.end(), parsed[i].begin(), parsed[i].end());
+            skipped += failed[i];
+        }
+        return positions;
+    }
+
+    // Coefficient of every parameter in evaluate(), passed to visit(index, coefficient).
+    template <typename Visit>
+    static void forEachFeature(const Position& position, Visit&& visit)
+    {
+        double mgScale = position.phase / double(EvalTables::MAX_PHASE);
+        double egScale = 1.0 - mgScale;
+        for (int i = 0; i < position.pieceCount; i++)
+        {
+            int piece = position.pieces[i];
+            int type = piece % 6;
+            bool white = piece < BLACK_PAWN;
+            int square = white ? position.squares[i] : position.squares[i] ^ 56;
+            double sign = white ? 1.0 : -1.0;
+            visit(MG_VALUE + type, sign * mgScale);
+            visit(EG_VALUE + type, sign * egScale);
+            visit(MG_TABLE + type * 64 + square, sign * mgScale);
+            visit(EG_TABLE + type * 64 + square, sign * egScale);
+        }
+        visit(DOUBLED_MG, position.doubled * mgScale);
+        visit(DOUBLED_EG, position.doubled * egScale);
+        visit(ISOLATED_MG, position.isolated * mgScale);
+        visit(ISOLATED_EG, position.isolated * egScale);
+        for (int rank = 0; rank < 8; rank++)
+        {
+            if (!position.passed[rank])
+                continue;
+            visit(PASSED_MG + rank, position.passed[rank] * mgScale);
+            visit(PASSED_EG + rank, position.passed[rank] * egScale);
+        }
+        visit(MOBILITY, double(position.mobility));
+    }
+
+    double evaluate(const Parameters& parameters, const Position& position)
+    {
+        double score = 0.0;
+        forEachFeature(position, [&](int index, double coefficient) { score += parameters[index] * coefficient; });
+        return score;
+    }
+
+    static double sigmoid(double k, double score)
+    {
+        return 1.0 / (1.0 + std::exp(-k * score * (std::numbers::ln10 / 400.0)));
+    }
+
+    // Runs work(begin, end, thread) over equal slices of the positions.
+    template <typename Work>
+    static void parallelFor(size_t count, int threads, Work&& work)
+    {
+        threads = std::clamp(threads, 1, static_cast<int>(std::max<size_t>(1, count)));
+        std::vector<std::thread> workers;
+        for (int i = 1; i < threads; i++)
+            workers.emplace_back([&, i]() { work(count * i / threads, count * (i + 1) / threads, i); });
+        work(0, count / threads, 0);
+        for (auto& thread : workers)
+            thread.join();
+    }
+
+    double error(const Parameters& parameters, const std::vector<Position>& positions, double k, int threads)
+    {
+        if (positions.empty())
+            return 0.0;
+        std::vector<double> sums(std::max(1, threads), 0.0);
+        parallelFor(positions.size(), threads, [&](size_t begin, size_t end, int thread)
+        {
+            double sum = 0.0;
+            for (size_t i = begin; i < end; i++)
+            {
+                double difference = positions[i].result - sigmoid(k, evaluate(parameters, positions[i]));
+                sum += difference * difference;
+            }
+            sums[thread] = sum;
+        });
+        double total = 0.0;
+        for (double sum : sums)
+            total += sum;
+        return total / positions.size();
+    }
+
+    double findScalingConstant(const Parameters& parameters, const std::vector<Position>& positions, int threads)
+    {
+        // The error is unimodal in k; golden-section search over a generous range.
+        const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+        double low = 0.0, high = 5.0;
+        double a = high - ratio * (high - low), b = low + ratio * (high - low);
+        double errorA = error(parameters, positions, a, threads), errorB = error(parameters, positions, b, threads);
+        while (high - low > 1e-4)
+        {
+            if (errorA < errorB)
+            {
+                high = b;
+                b = a;
+                errorB = errorA;
+                a = high - ratio * (high - low);
+                errorA = error(parameters, positions, a, threads);
+            }
+            else
+            {
+                low = a;
+                a = b;
+                errorA = errorB;
+                b = low + ratio * (high - low);
+                errorB = error(parameters, positions, b, threads);
+            }
+        }
+        return (low + high) / 2.0;
+    }
+
+    double tune(Parameters& parameters, const std::vector<Position>& positions, double k, const Options& options)
+    {
+        if (positions.empty())
+            return 0.0;
+        const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+        Parameters momentum{}, velocity{};
+        int threads = std::max(1, options.threads);
+        std::vector<Parameters> gradients(threads);
+
+        for (int iteration = 1; iteration <= options.iterations; iteration++)
+        {
+            // d error / d eval = -2 (result - s) s (1 - s) k ln(10) / 400
+            parallelFor(positions.size(), threads, [&](size_t begin, size_t end, int thread)
+            {
+                Parameters& gradient = gradients[thread];
+                gradient.fill(0.0);
+                for (size_t i = begin; i < end; i++)
+                {
+                    double s = sigmoid(k, evaluate(parameters, positions[i]));
+                    double slope = (s - positions[i].result) * s * (1.0 - s);
+                    forEachFeature(positions[i], [&](int index, double coefficient) { gradient[index] += slope * coefficient; });
+                }
+            });
+
+            const double scale = 2.0 * k * std::numbers::ln10 / 400.0 / positions.size();
+            for (int index = 0; index < PARAMETER_COUNT; index++)
+            {
+                double gradient = 0.0;
+                for (int thread = 0; thread < threads; thread++)
+                    gradient += gradients[thread][index];
+                gradient *= scale;
+
+                momentum[index] = beta1 * momentum[index] + (1.0 - beta1) * gradient;
+                velocity[index] = beta2 * velocity[index] + (1.0 - beta2) * gradient * gradient;
+                double corrected = momentum[index] / (1.0 - std::pow(beta1, iteration));
+                double variance = velocity[index] / (1.0 - std::pow(beta2, iteration));
+                parameters[index] -= options.learningRate * corrected / (std::sqrt(variance) + epsilon);
+            }
+
+            if (options.reportEvery > 0 && iteration % options.reportEvery == 0)
+                std::cerr << "Iteration " << iteration << ": error " << std::setprecision(8)
+                          << error(parameters, positions, k, threads) << std::endl;
+        }
+        return error(parameters, positions, k, threads);
+    }
+
+    static void writeTable(std::ostream& out, const Parameters& parameters, int offset, const char* const names[6])
+    {
+        for (int type = PAWN; type <= KING; type++)
+        {
+            out << "        { // " << names[type] << "\n";
+            for (int row = 0; row < 8; row++)
+            {
+                out << "         ";
+                for (int col = 0; col < 8; col++)
+                    out << std::setw(4) << std::lround(parameters[offset + type * 64 + row * 8 + col]) << ",";
+                out << "\n";
+            }
+            out << "        },\n";
+        }
+    }
+
+    static void writeArray(std::ostream& out, const Parameters& parameters, int offset, int count)
+    {
+        out << "{ ";
+        for (int i = 0; i < count; i++)
+            out << std::lround(parameters[offset + i]) << (i + 1 < count ? ", " : " ");
+        out << "}";
+    }
+
+    void writeHeader(const Parameters& parameters, std::ostream& out)
+    {
+        static const char* const names[6] = { "Pawn", "Knight", "Bishop", "Rook", "Queen", "King" };
+        auto value = [&](int index) { return std::lround(parameters[index]); };
+
+        out << "#pragma once\n\n\n"
+               "// Material values and piece-square tables for the midgame (mg) and endgame (eg),\n"
+               "// indexed by PieceType and by square (row * 8 + col) from white's point of view;\n"
+               "// black pieces read the table mirrored vertically (square ^ 56). PerchFishTune writes\n"
+               "// a replacement for this file with tuned values.\n"
+               "namespace EvalTables\n{\n";
+        out << "    constexpr int mgValue[6] = ";
+        writeArray(out, parameters, MG_VALUE, 6);
+        out << ";\n    constexpr int egValue[6] = ";
+        writeArray(out, parameters, EG_VALUE, 6);
+        out << ";\n\n"
+               "    // Game phase contribution by PieceType; a full set of pieces adds up to MAX_PHASE.\n"
+               "    constexpr int phaseWeight[6] = { ";
+        for (int type = PAWN; type <= KING; type++)
+            out << EvalTables::phaseWeight[type] << (type < KING ? ", " : " ");
+        out << "};\n    constexpr int MAX_PHASE = " << EvalTables::MAX_PHASE << ";\n\n";
+
+        out << "    constexpr int mgTable[6][64] = {\n";
+        writeTable(out, parameters, MG_TABLE, names);
+        out << "    };\n\n    constexpr int egTable[6][64] = {\n";
+        writeTable(out, parameters, EG_TABLE, names);
+        out << "    };\n\n";
+
+        out << "    // Pawn structure terms. Passed pawn bonuses are indexed by rank counted from the\n"
+               "    // pawn's own side (1 = starting rank, 6 = one step from promotion).\n"
+            << "    constexpr int doubledPawnMg = " << value(DOUBLED_MG) << ", doubledPawnEg = " << value(DOUBLED_EG) << ";\n"
+            << "    constexpr int isolatedPawnMg = " << value(ISOLATED_MG) << ", isolatedPawnEg = " << value(ISOLATED_EG) << ";\n"
+            << "    constexpr int passedPawnMg[8] = ";
+        writeArray(out, parameters, PASSED_MG, 8);
+        out << ";\n    constexpr int passedPawnEg[8] = ";
+        writeArray(out, parameters, PASSED_EG, 8);
+        out << ";\n\n"
+               "    // Per attacked square, in both game phases\n"
+               "    constexpr int mobilityWeight = " << value(MOBILITY) << ";\n"
+               "}\n";
+    }
+}
@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Engine.hpp"
+
+// Perft reference positions, searched to a fixed depth.
+static const char* benchPositions[] = {
+    "rnbqkbnrpppppppp00000000000000000000000000000000PPPPPPPPRNBQKBNR1000000",
+    "r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000",
+    "0000000000p00000000p0000KP00000r0R000p0k000000000000P0P0000000001111111",
+    "r000k00rPppp0ppp0b000nbNnP000000BBP0P000q0000N00Pp0P00PPR00Q0RK01101100",
+    "rnbq0k0rpp0Pbppp00p000000000000000B0000000000000PPP0NnPPRNBQK00R1010011",
+    "r0000rk00pp0qpppp0np0n0000b0p0B000B0P0b0P0NP0N000PP0QPPPR0000RK01111111",
+};
+
+// Usage: PerchFishBench [depth] [--threads 1,2,4,8,16] [--hash MB]
+// Time to depth of the Lazy SMP search for each thread count, with a fresh engine
+// (empty tables) per position and count.
+int main(int argc, char** argv)
+{
+    int depth = 7;
+    size_t hashMB = Engine::DEFAULT_HASH_MB;
+    std::vector<int> threadCounts = { 1, 2, 4, 8, 16 };
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+        {
+            threadCounts.clear();
+            std::stringstream list(argv[++i]);
+            for (std::string count; std::getline(list, count, ','); )
+                threadCounts.push_back(std::max(std::atoi(count.c_str()), 1));
+        }
+        else if (arg == "--hash" && i + 1 < argc)
+            hashMB = std::strtoull(argv[++i], nullptr, 10);
+        else
+            depth = std::max(std::atoi(arg.c_str()), 1);
+    }
+
+    double baseline = 0;
+    for (int threads : threadCounts)
+    {
+        double seconds = 0;
+        uint64_t nodes = 0;
+        for (const char* position : benchPositions)
+        {
+            Engine engine(":memory:", hashMB);
+            engine.setThreads(threads);
+            ChessState state(position);
+            SearchStack stack;
+
+            auto start = std::chrono::steady_clock::now();
+            engine.search(state, depth, stack);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            nodes += stack.nodes;
+        }
+        if (baseline == 0)
+            baseline = seconds;
+
+        std::cout << "Threads: " << threads
+                  << "  Time: " << seconds << " s"
+                  << "  Speedup: " << baseline / seconds
+                  << "  Main thread nodes: " << nodes << std::endl;
+    }
+    return 0;
+}
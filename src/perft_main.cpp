@@ -0,0 +1,53 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "Perft.hpp"
+
+// Usage: PerchFishPerft <depth> [state] [--divide] [--threads N] [--hash MB]
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <depth> [state] [--divide] [--threads N] [--hash MB]" << std::endl;
+        return 1;
+    }
+
+    int depth = std::atoi(argv[1]);
+    std::string stateStr = "rnbqkbnrpppppppp00000000000000000000000000000000PPPPPPPPRNBQKBNR1000000";
+    PerftOptions options;
+
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--divide")
+            options.divide = true;
+        else if (arg == "--threads" && i + 1 < argc)
+            options.threads = std::atoi(argv[++i]);
+        else if (arg == "--hash" && i + 1 < argc)
+            options.hashMB = std::strtoull(argv[++i], nullptr, 10);
+        else
+            stateStr = arg;
+    }
+    if (options.threads <= 0)
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    try
+    {
+        ChessState state(stateStr);
+        PerftResult result = runPerft(state, depth, options);
+
+        for (const auto& [move, nodes] : result.divide)
+            std::cout << move.toString() << ": " << nodes << "\n";
+
+        std::cout << "Nodes: " << result.nodes << "\n"
+                  << "Time: " << result.seconds << " s\n"
+                  << "Nodes/sec: " << static_cast<uint64_t>(result.nodesPerSecond()) << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "Tuner.hpp"
+
+// Usage: PerchFishTune <positions> [--output FILE] [--iterations N] [--rate R] [--threads N]
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <positions> [--output FILE] [--iterations N] [--rate R] [--threads N]" << std::endl;
+        return 1;
+    }
+
+    std::string inputPath = argv[1];
+    std::string outputPath = "EvalTables.hpp";
+    Tuner::Options options;
+    options.threads = 0;
+
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--output" && i + 1 < argc)
+            outputPath = argv[++i];
+        else if (arg == "--iterations" && i + 1 < argc)
+            options.iterations = std::atoi(argv[++i]);
+        else if (arg == "--rate" && i + 1 < argc)
+            options.learningRate = std::atof(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc)
+            options.threads = std::atoi(argv[++i]);
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (options.threads <= 0)
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    try
+    {
+        auto start = std::chrono::steady_clock::now();
+        size_t skipped = 0;
+        std::vector<Tuner::Position> positions = Tuner::loadPositions(inputPath, options.threads, skipped);
+        std::cerr << "Loaded " << positions.size() << " positions (" << skipped << " lines skipped)" << std::endl;
+        if (positions.empty())
+            return 1;
+
+        Tuner::Parameters parameters = Tuner::defaultParameters();
+        double k = Tuner::findScalingConstant(parameters, positions, options.threads);
+        std::cerr << "K: " << k << ", initial error: " << Tuner::error(parameters, positions, k, options.threads) << std::endl;
+
+        double finalError = Tuner::tune(parameters, positions, k, options);
+
+        std::ofstream out(outputPath);
+        Tuner::writeHeader(parameters, out);
+        if (!out)
+        {
+            std::cerr << "Failed to write " << outputPath << std::endl;
+            return 1;
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Final error: " << finalError << "\n"
+                  << "Time: " << seconds << " s\n"
+                  << "Wrote " << outputPath << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
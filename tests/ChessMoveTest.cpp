@@ -10,27 +10,27 @@ TEST(ChessMoveTest, DefaultConstructor) {
 }
 
 TEST(ChessMoveTest, ParameterizedConstructor) {
-    ChessMove move(1, 2, 3, 4, 5);
+    ChessMove move(1, 2, 3, 4, 3);
     EXPECT_EQ(move.getFrom(), std::make_pair(1, 2));
     EXPECT_EQ(move.getTo(), std::make_pair(3, 4));
-    EXPECT_EQ(move.getPromotion(), 5);
+    EXPECT_EQ(move.getPromotion(), 3);
 }
 
 TEST(ChessMoveTest, CopyConstructor) {
-    ChessMove move1(1, 2, 3, 4, 5);
+    ChessMove move1(1, 2, 3, 4, 3);
     ChessMove move2(move1);
     EXPECT_EQ(move2.getFrom(), std::make_pair(1, 2));
     EXPECT_EQ(move2.getTo(), std::make_pair(3, 4));
-    EXPECT_EQ(move2.getPromotion(), 5);
+    EXPECT_EQ(move2.getPromotion(), 3);
 }
 
 TEST(ChessMoveTest, AssignmentOperator) {
-    ChessMove move1(1, 2, 3, 4, 5);
+    ChessMove move1(1, 2, 3, 4, 3);
     ChessMove move2;
     move2 = move1;
     EXPECT_EQ(move2.getFrom(), std::make_pair(1, 2));
     EXPECT_EQ(move2.getTo(), std::make_pair(3, 4));
-    EXPECT_EQ(move2.getPromotion(), 5);
+    EXPECT_EQ(move2.getPromotion(), 3);
 }
 
 TEST(ChessMoveTest, SetFrom) {
@@ -47,24 +47,24 @@ TEST(ChessMoveTest, SetTo) {
 
 TEST(ChessMoveTest, SetPromotion) {
     ChessMove move;
-    move.setPromotion(5);
-    EXPECT_EQ(move.getPromotion(), 5);
+    move.setPromotion(2);
+    EXPECT_EQ(move.getPromotion(), 2);
 }
 
 TEST(ChessMoveTest, EqualityOperator) {
-    ChessMove move1(1, 2, 3, 4, 5);
-    ChessMove move2(1, 2, 3, 4, 5);
+    ChessMove move1(1, 2, 3, 4, 3);
+    ChessMove move2(1, 2, 3, 4, 3);
     EXPECT_TRUE(move1 == move2);
 }
 
 TEST(ChessMoveTest, InequalityOperator) {
-    ChessMove move1(1, 2, 3, 4, 5);
-    ChessMove move2(1, 2, 3, 4, 6);
+    ChessMove move1(1, 2, 3, 4, 3);
+    ChessMove move2(1, 2, 3, 4, 2);
     EXPECT_TRUE(move1 != move2);
 }
 
 TEST(ChessMoveTest, PrintMove) {
-    ChessMove move(1, 2, 3, 4, 5);
+    ChessMove move(1, 2, 3, 4, 3);
     testing::internal::CaptureStdout();
     move.printMove();
     std::string output = testing::internal::GetCapturedStdout();
@@ -72,18 +72,18 @@ TEST(ChessMoveTest, PrintMove) {
 }
 
 TEST(ChessMoveTest, GetFrom) {
-    ChessMove move(1, 2, 3, 4, 5);
+    ChessMove move(1, 2, 3, 4, 3);
     EXPECT_EQ(move.getFrom(), std::make_pair(1, 2));
 }
 
 TEST(ChessMoveTest, GetTo) {
-    ChessMove move(1, 2, 3, 4, 5);
+    ChessMove move(1, 2, 3, 4, 3);
     EXPECT_EQ(move.getTo(), std::make_pair(3, 4));
 }
 
 TEST(ChessMoveTest, GetPromotion) {
-    ChessMove move(1, 2, 3, 4, 5);
-    EXPECT_EQ(move.getPromotion(), 5);
+    ChessMove move(1, 2, 3, 4, 3);
+    EXPECT_EQ(move.getPromotion(), 3);
 }
 
 TEST(ChessMoveTest, SetFromAndGetFrom) {
@@ -94,92 +94,114 @@ TEST(ChessMoveTest, SetFromAndGetFrom) {
 
 TEST(ChessMoveTest, SetToAndGetTo) {
     ChessMove move;
-    move.setTo({7, 8});
-    EXPECT_EQ(move.getTo(), std::make_pair(7, 8));
+    move.setTo({7, 6});
+    EXPECT_EQ(move.getTo(), std::make_pair(7, 6));
 }
 
 TEST(ChessMoveTest, SetPromotionAndGetPromotion) {
     ChessMove move;
-    move.setPromotion(9);
-    EXPECT_EQ(move.getPromotion(), 9);
+    move.setPromotion(1);
+    EXPECT_EQ(move.getPromotion(), 1);
 }
 
 TEST(ChessMoveTest, EqualityOperatorWithDifferentFrom) {
-    ChessMove move1(1, 2, 3, 4, 5);
-    ChessMove move2(2, 2, 3, 4, 5);
+    ChessMove move1(1, 2, 3, 4, 3);
+    ChessMove move2(2, 2, 3, 4, 3);
     EXPECT_FALSE(move1 == move2);
 }
 
 TEST(ChessMoveTest, EqualityOperatorWithDifferentTo) {
-    ChessMove move1(1, 2, 3, 4, 5);
-    ChessMove move2(1, 2, 4, 4, 5);
+    ChessMove move1(1, 2, 3, 4, 3);
+    ChessMove move2(1, 2, 4, 4, 3);
     EXPECT_FALSE(move1 == move2);
 }
 
 TEST(ChessMoveTest, EqualityOperatorWithDifferentPromotion) {
-    ChessMove move1(1, 2, 3, 4, 5);
-    ChessMove move2(1, 2, 3, 4, 6);
+    ChessMove move1(1, 2, 3, 4, 3);
+    ChessMove move2(1, 2, 3, 4, 2);
     EXPECT_FALSE(move1 == move2);
 }
 
 TEST(ChessMoveTest, InequalityOperatorWithSameMoves) {
-    ChessMove move1(1, 2, 3, 4, 5);
-    ChessMove move2(1, 2, 3, 4, 5);
+    ChessMove move1(1, 2, 3, 4, 3);
+    ChessMove move2(1, 2, 3, 4, 3);
     EXPECT_FALSE(move1 != move2);
 }
 
 TEST(ChessMoveTest, InequalityOperatorWithDifferentFrom) {
-    ChessMove move1(1, 2, 3, 4, 5);
-    ChessMove move2(2, 2, 3, 4, 5);
+    ChessMove move1(1, 2, 3, 4, 3);
+    ChessMove move2(2, 2, 3, 4, 3);
     EXPECT_TRUE(move1 != move2);
 }
 
 TEST(ChessMoveTest, InequalityOperatorWithDifferentTo) {
-    ChessMove move1(1, 2, 3, 4, 5);
-    ChessMove move2(1, 2, 4, 4, 5);
+    ChessMove move1(1, 2, 3, 4, 3);
+    ChessMove move2(1, 2, 4, 4, 3);
     EXPECT_TRUE(move1 != move2);
 }
 
 TEST(ChessMoveTest, InequalityOperatorWithDifferentPromotion) {
-    ChessMove move1(1, 2, 3, 4, 5);
-    ChessMove move2(1, 2, 3, 4, 6);
+    ChessMove move1(1, 2, 3, 4, 3);
+    ChessMove move2(1, 2, 3, 4, 2);
     EXPECT_TRUE(move1 != move2);
 }
 
-TEST(ChessMoveTest, SetFromWithNegativeValues) {
-    ChessMove move;
-    move.setFrom({-1, -2});
-    EXPECT_EQ(move.getFrom(), std::make_pair(-1, -2));
-}
-
-TEST(ChessMoveTest, SetToWithNegativeValues) {
-    ChessMove move;
-    move.setTo({-3, -4});
-    EXPECT_EQ(move.getTo(), std::make_pair(-3, -4));
-}
-
-TEST(ChessMoveTest, SetPromotionWithNegativeValue) {
-    ChessMove move;
-    move.setPromotion(-5);
-    EXPECT_EQ(move.getPromotion(), -5);
-}
-
-TEST(ChessMoveTest, SetFromWithLargeValues) {
-    ChessMove move;
-    move.setFrom({1000, 2000});
-    EXPECT_EQ(move.getFrom(), std::make_pair(1000, 2000));
-}
-
-TEST(ChessMoveTest, SetToWithLargeValues) {
-    ChessMove move;
-    move.setTo({3000, 4000});
-    EXPECT_EQ(move.getTo(), std::make_pair(3000, 4000));
-}
-
-TEST(ChessMoveTest, SetPromotionWithLargeValue) {
-    ChessMove move;
-    move.setPromotion(5000);
-    EXPECT_EQ(move.getPromotion(), 5000);
+TEST(ChessMoveTest, SetFromWithBoundaryValues) {
+    ChessMove move(4, 4, 3, 3, 1);
+    move.setFrom({0, 0});
+    EXPECT_EQ(move.getFrom(), std::make_pair(0, 0));
+    move.setFrom({7, 7});
+    EXPECT_EQ(move.getFrom(), std::make_pair(7, 7));
+    EXPECT_EQ(move.getTo(), std::make_pair(3, 3));
+    EXPECT_EQ(move.getPromotion(), 1);
+}
+
+TEST(ChessMoveTest, SetToWithBoundaryValues) {
+    ChessMove move(4, 4, 3, 3, 1);
+    move.setTo({0, 7});
+    EXPECT_EQ(move.getTo(), std::make_pair(0, 7));
+    move.setTo({7, 0});
+    EXPECT_EQ(move.getTo(), std::make_pair(7, 0));
+    EXPECT_EQ(move.getFrom(), std::make_pair(4, 4));
+    EXPECT_EQ(move.getPromotion(), 1);
+}
+
+TEST(ChessMoveTest, SetPromotionWithAllPieces) {
+    ChessMove move(1, 0, 0, 0);
+    for (int promotion = 0; promotion < 4; promotion++) {
+        move.setPromotion(promotion);
+        EXPECT_EQ(move.getPromotion(), promotion);
+        EXPECT_EQ(move.getFrom(), std::make_pair(1, 0));
+        EXPECT_EQ(move.getTo(), std::make_pair(0, 0));
+    }
+}
+
+TEST(ChessMoveTest, PackedIntoSixteenBits) {
+    EXPECT_EQ(sizeof(ChessMove), 2u);
+    EXPECT_TRUE(std::is_trivially_copyable_v<ChessMove>);
+}
+
+TEST(ChessMoveTest, SquareAccessors) {
+    constexpr ChessMove move = ChessMove::fromSquares(52, 36);
+    static_assert(move.fromSquare() == 52 && move.toSquare() == 36);
+    EXPECT_EQ(move.getFrom(), std::make_pair(6, 4));
+    EXPECT_EQ(move.getTo(), std::make_pair(4, 4));
+    EXPECT_EQ(move.getFlag(), ChessMove::NORMAL);
+}
+
+TEST(ChessMoveTest, ToStringWireFormat) {
+    EXPECT_EQ(ChessMove(6, 4, 4, 4, 0).toString(), "64440");
+    EXPECT_EQ(ChessMove(1, 0, 0, 0, 3).toString(), "10003");
+    char buffer[5];
+    ChessMove(7, 4, 7, 6).format(buffer);
+    EXPECT_EQ(std::string(buffer, 5), "74760");
+}
+
+TEST(ChessMoveTest, FlagDoesNotAffectEquality) {
+    ChessMove castling = ChessMove::fromSquares(60, 62, ChessMove::CASTLING);
+    EXPECT_EQ(castling.getFlag(), ChessMove::CASTLING);
+    EXPECT_TRUE(castling == ChessMove(7, 4, 7, 6, 0));
+    EXPECT_TRUE(ChessMove::fromSquares(8, 0, ChessMove::PROMOTION, 2) != ChessMove(1, 0, 0, 0, 0));
 }
 
 int main(int argc, char **argv) {
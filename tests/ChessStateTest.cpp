@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include "ChessState.hpp"
 
 class TestChessState : public ChessState {
@@ -127,9 +128,9 @@ TEST_F(ChessStateTestFixture, isInCheckMate){
     EXPECT_TRUE(state.isSquareAttacked(6, 1, false));
     EXPECT_FALSE(state.isSquareAttacked(0, 0, false));
 
-    EXPECT_FALSE(state.isLegalMove(ChessMove(7, 0, 6, 0, 0)));
-    EXPECT_FALSE(state.isLegalMove(ChessMove(7, 0, 6, 1, 0)));
-    EXPECT_FALSE(state.isLegalMove(ChessMove(7, 0, 7, 1, 0)));
+    std::vector<ChessMove> legalMoves = state.getLegalMoves();
+    for (const ChessMove& kingMove : { ChessMove(7, 0, 6, 0, 0), ChessMove(7, 0, 6, 1, 0), ChessMove(7, 0, 7, 1, 0) })
+        EXPECT_EQ(std::find(legalMoves.begin(), legalMoves.end(), kingMove), legalMoves.end());
 
 
     EXPECT_TRUE(state.isTerminal());
@@ -199,3 +200,186 @@ TEST_F(ChessStateTestFixture, MultipleMovesAndUnmakes) {
     EXPECT_EQ(chessState.getPieceAt(1, 4), 'p');
     EXPECT_EQ(chessState.getPieceAt(4, 4), '0');
 }
+
+TEST_F(ChessStateTestFixture, LongGamesKeepTheLastUndoRecords) {
+    // Knights out and back, past the undo history's capacity
+    const ChessMove cycle[] = {
+        ChessMove(7, 6, 5, 5, 0), ChessMove(0, 6, 2, 5, 0),
+        ChessMove(5, 5, 7, 6, 0), ChessMove(2, 5, 0, 6, 0),
+    };
+    const size_t moves = 600;
+    for (size_t i = 0; i < moves; i++)
+        chessState.makeMove(cycle[i % 4]);
+    EXPECT_EQ(chessState.toString(), initial_state);
+
+    // The last 512 moves can be taken back; older ones are forgotten.
+    chessState.unmakeMove(cycle[(moves - 1) % 4]);
+    EXPECT_EQ(chessState.getPieceAt(2, 5), 'n');
+    for (size_t i = moves - 1; i-- > moves - 512; )
+        chessState.unmakeMove(cycle[i % 4]);
+    EXPECT_EQ(chessState.toString(), initial_state);
+    EXPECT_EQ(chessState.getKey(), chessState.computeKey());
+    chessState.unmakeMove(cycle[(moves - 513) % 4]);
+    EXPECT_EQ(chessState.toString(), initial_state);
+}
+
+TEST_F(ChessStateTestFixture, EnPassantIsGenerated) {
+    chessState.makeMove(ChessMove(6, 4, 4, 4, 0)); // e2 to e4
+    chessState.makeMove(ChessMove(1, 0, 2, 0, 0)); // a7 to a6
+    chessState.makeMove(ChessMove(4, 4, 3, 4, 0)); // e4 to e5
+    chessState.makeMove(ChessMove(1, 3, 3, 3, 0)); // d7 to d5
+    std::vector<ChessMove> legalMoves = chessState.getLegalMoves();
+    ChessMove enPassant(3, 4, 2, 3, 0); // e5 takes d6 en passant
+    EXPECT_NE(std::find(legalMoves.begin(), legalMoves.end(), enPassant), legalMoves.end());
+    chessState.makeMove(enPassant);
+    EXPECT_EQ(chessState.getPieceAt(2, 3), 'P');
+    EXPECT_EQ(chessState.getPieceAt(3, 3), '0');
+    chessState.unmakeMove(enPassant);
+    EXPECT_EQ(chessState.getPieceAt(3, 3), 'p');
+    EXPECT_EQ(chessState.getPieceAt(3, 4), 'P');
+}
+
+TEST_F(ChessStateTestFixture, EnPassantDiscoveredCheckIsIllegal) {
+    // White king and pawn on the fifth rank with a black rook behind the black pawn.
+    TestChessState state("0000k00000p0000000000000KP00000r000000000000000000000000000000000111111");
+    state.makeMove(ChessMove(1, 2, 3, 2, 0)); // c7 to c5
+    std::vector<ChessMove> legalMoves = state.getLegalMoves();
+    EXPECT_EQ(std::find(legalMoves.begin(), legalMoves.end(), ChessMove(3, 1, 2, 2, 0)), legalMoves.end());
+    EXPECT_NE(std::find(legalMoves.begin(), legalMoves.end(), ChessMove(3, 1, 2, 1, 0)), legalMoves.end());
+}
+
+TEST_F(ChessStateTestFixture, PinnedPieceStaysOnPinLine) {
+    // White rook on e2 pinned to the king on e1 by a black rook on e8.
+    TestChessState state("k000r00000000000000000000000000000000000000000000000R0000000K0001111111");
+    for (const ChessMove& move : state.getLegalMoves()) {
+        if (move.getFrom() == std::make_pair(6, 4)) {
+            EXPECT_EQ(move.getTo().second, 4);
+        }
+    }
+}
+
+static void checkKeysBelow(ChessState& state, int depth) {
+    if (depth == 0)
+        return;
+    for (const ChessMove& move : state.getLegalMoves()) {
+        uint64_t before = state.getKey();
+        state.makeMove(move);
+        ASSERT_EQ(state.getKey(), state.computeKey()) << move.toString();
+        checkKeysBelow(state, depth - 1);
+        state.unmakeMove(move);
+        ASSERT_EQ(state.getKey(), before) << move.toString();
+    }
+}
+
+TEST_F(ChessStateTestFixture, IncrementalKeyMatchesComputedKey) {
+    // Kiwipete exercises castling, en passant and promotions within a few plies.
+    TestChessState state("r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000");
+    EXPECT_EQ(state.getKey(), state.computeKey());
+    checkKeysBelow(state, 3);
+}
+
+TEST_F(ChessStateTestFixture, TranspositionsShareKey) {
+    uint64_t initialKey = chessState.getKey();
+    chessState.makeMove(ChessMove(7, 6, 5, 5, 0)); // g1 to f3
+    EXPECT_NE(chessState.getKey(), initialKey);
+    chessState.makeMove(ChessMove(0, 6, 2, 5, 0)); // g8 to f6
+    chessState.makeMove(ChessMove(5, 5, 7, 6, 0)); // f3 to g1
+    chessState.makeMove(ChessMove(2, 5, 0, 6, 0)); // f6 to g8
+    EXPECT_EQ(chessState.getKey(), initialKey);
+    EXPECT_EQ(chessState.toString(), initial_state);
+}
+
+TEST_F(ChessStateTestFixture, CopyDoesNotCarryUndoHistory) {
+    static_assert(sizeof(ChessState::UndoRecord) <= 16, "undo records should stay compact");
+    chessState.makeMove(ChessMove(6, 4, 4, 4, 0)); // e2 to e4
+    chessState.makeMove(ChessMove(1, 4, 3, 4, 0)); // e7 to e5
+    ASSERT_EQ(chessState.undoStack.size(), 2u);
+
+    ChessState copy = chessState;
+    EXPECT_TRUE(copy.undoStack.empty());
+    EXPECT_EQ(copy.toString(), chessState.toString());
+    EXPECT_EQ(copy.getKey(), chessState.getKey());
+
+    // The original can still be unwound after the copy.
+    chessState.unmakeMove(ChessMove(1, 4, 3, 4, 0));
+    chessState.unmakeMove(ChessMove(6, 4, 4, 4, 0));
+    EXPECT_EQ(chessState.toString(), initial_state);
+}
+
+TEST_F(ChessStateTestFixture, NodeStatusClassifiesInOnePass) {
+    MoveList moves;
+    EXPECT_EQ(chessState.nodeStatus(moves), ChessState::NORMAL);
+    EXPECT_EQ(moves.size(), 20u);
+
+    ChessState mate("0nbqkbnr00qqqqqq0000000000000000000000000000000000000000K00000001000000");
+    EXPECT_EQ(mate.nodeStatus(moves), ChessState::CHECKMATE);
+    EXPECT_TRUE(moves.empty());
+
+    ChessState stalemate("0000000k000000000000000000000000000000000q00000000000000K00000001000000");
+    EXPECT_EQ(stalemate.nodeStatus(moves), ChessState::STALEMATE);
+    EXPECT_TRUE(moves.empty());
+
+    ChessState check("r000000k000000000000000000000000000000000000000000000000K00000001000000");
+    EXPECT_EQ(check.nodeStatus(moves), ChessState::IN_CHECK);
+    EXPECT_EQ(moves.size(), 2u);
+}
+
+TEST_F(ChessStateTestFixture, KingSquaresTrackedIncrementally) {
+    EXPECT_EQ(chessState.kingSquare[WHITE], squareOf(7, 4));
+    EXPECT_EQ(chessState.kingSquare[BLACK], squareOf(0, 4));
+
+    TestChessState state("r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000");
+    ChessMove castling(7, 4, 7, 6, 0); // White king-side castling
+    state.makeMove(castling);
+    EXPECT_EQ(state.getWhiteKingRow(), 7);
+    EXPECT_EQ(state.getWhiteKingCol(), 6);
+    state.unmakeMove(castling);
+    EXPECT_EQ(state.kingSquare[WHITE], squareOf(7, 4));
+
+    ChessState noBlackKing("0000000000000000000000000000000000000000000000000000000000000K001000000");
+    EXPECT_EQ(noBlackKing.getBlackKingRow(), -1);
+    EXPECT_EQ(noBlackKing.getWhiteKingCol(), 5);
+}
+
+static void checkEvalBelow(ChessState& state, int depth) {
+    if (depth == 0)
+        return;
+    for (const ChessMove& move : state.getLegalMoves()) {
+        state.makeMove(move);
+        ChessState fresh(state.toString());
+        ASSERT_EQ(state.mgScore, fresh.mgScore) << move.toString();
+        ASSERT_EQ(state.egScore, fresh.egScore) << move.toString();
+        ASSERT_EQ(state.phase, fresh.phase) << move.toString();
+        checkEvalBelow(state, depth - 1);
+        state.unmakeMove(move);
+    }
+}
+
+TEST_F(ChessStateTestFixture, IncrementalEvalMatchesFreshState) {
+    EXPECT_EQ(chessState.psqScore(), 0);
+    EXPECT_EQ(chessState.phase, 24);
+
+    // Castling and en passant both occur within three plies here.
+    TestChessState state("r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000");
+    int mg = state.mgScore, eg = state.egScore;
+    checkEvalBelow(state, 3);
+    EXPECT_EQ(state.mgScore, mg);
+    EXPECT_EQ(state.egScore, eg);
+
+    // Promotions swap the pawn's terms for the new piece's and add to the phase.
+    TestChessState promotion("00000000P00000000000000000000000000000000000000000000000000000001000000");
+    checkEvalBelow(promotion, 1);
+    promotion.makeMove(ChessMove(1, 0, 0, 0, 0));
+    EXPECT_EQ(promotion.phase, 4);
+}
+
+TEST_F(ChessStateTestFixture, MobilityCountsAttackedSquares) {
+    // Only the knights can reach squares at the start: a3, c3, f3 and h3 for white.
+    EXPECT_EQ(chessState.mobility(WHITE), 4);
+    EXPECT_EQ(chessState.mobility(BLACK), 4);
+
+    // e2 to e4 frees e2 for the g1 knight and opens the bishop (a6-e2) and queen (e2-h5).
+    chessState.makeMove(ChessMove(6, 4, 4, 4, 0));
+    EXPECT_EQ(chessState.mobility(WHITE), 5 + 5 + 4);
+    EXPECT_EQ(chessState.mobility(BLACK), 4);
+}
@@ -0,0 +1,295 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include "Engine.hpp"
+
+// Count heap allocations made while a flag is raised, by replacing the global
+// allocation functions for the test binary. Every form is replaced so that each
+// new is paired with a matching delete.
+static std::atomic<bool> countAllocations{false};
+static std::atomic<size_t> allocationCount{0};
+
+static void* countedAlloc(std::size_t size, std::size_t alignment = 0) noexcept
+{
+    if (countAllocations)
+        allocationCount++;
+    if (size == 0)
+        size = 1;
+    if (alignment <= alignof(std::max_align_t))
+        return std::malloc(size);
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+static void* countedAllocOrThrow(std::size_t size, std::size_t alignment = 0)
+{
+    if (void* ptr = countedAlloc(size, alignment))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return countedAllocOrThrow(size); }
+void* operator new[](std::size_t size) { return countedAllocOrThrow(size); }
+void* operator new(std::size_t size, std::align_val_t al) { return countedAllocOrThrow(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return countedAllocOrThrow(size, static_cast<std::size_t>(al)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return countedAlloc(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return countedAlloc(size, static_cast<std::size_t>(al)); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+const std::string middlegame_state = "r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000";
+
+TEST(EngineTest, SearchFindsLegalMove) {
+    Engine engine(":memory:");
+    ChessState state(middlegame_state);
+    SearchStack stack;
+    auto [move, score] = engine.search(state, 2, stack);
+    std::vector<ChessMove> legalMoves = state.getLegalMoves();
+    EXPECT_NE(std::find(legalMoves.begin(), legalMoves.end(), move), legalMoves.end());
+    EXPECT_EQ(state.toString(), middlegame_state);
+}
+
+TEST(EngineTest, SearchDoesNotAllocate) {
+    Engine engine(":memory:");
+    ChessState state("rnbqkbnrpppppppp00000000000000000000000000000000PPPPPPPPRNBQKBNR1000000");
+    auto stack = std::make_unique<SearchStack>();
+
+    allocationCount = 0;
+    countAllocations = true;
+    engine.search(state, 5, *stack);
+    countAllocations = false;
+
+    EXPECT_EQ(allocationCount, 0u);
+}
+
+TEST(EngineTest, EvalCacheServesRepeatedLeaves) {
+    // Lazy bounds are not cached, so evaluate every leaf fully. The transposition
+    // table is kept minimal so that the second search reaches the leaves again.
+    Engine engine(":memory:", 0);
+    engine.setLazyMargin(SCORE_INFINITE);
+    ChessState state(middlegame_state);
+    SearchStack stack;
+
+    auto first = engine.search(state, 3, stack);
+    uint64_t probes = engine.getEvalCache().probes(), hits = engine.getEvalCache().hits();
+    EXPECT_GT(probes, 0u);
+
+    // A second search finds every non-terminal leaf in the cache and agrees with the first.
+    auto second = engine.search(state, 3, stack);
+    EXPECT_EQ(second.first, first.first);
+    EXPECT_EQ(second.second, first.second);
+    EXPECT_GT(engine.getEvalCache().hits() - hits, (engine.getEvalCache().probes() - probes) * 9 / 10);
+}
+
+TEST(EngineTest, CompositeHeuristicSumsWeightedTerms) {
+    ChessState state(middlegame_state);
+    CompositeHeuristic<Weighted<Heuristic1, 2>, Weighted<Heuristic2>> composite;
+    Score expected = 2 * Heuristic1()(state) + Heuristic2()(state);
+    EXPECT_EQ(composite.evaluate(state), expected);
+    EXPECT_EQ(static_cast<const Heuristic&>(composite)(state), expected);
+}
+
+TEST(EngineTest, RuntimeHeuristicsMatchDefaultEvaluation) {
+    Engine compiled(":memory:"), runtime(":memory:");
+    runtime.addHeuristic(std::make_unique<Heuristic2>());
+    ChessState state(middlegame_state);
+    SearchStack stack;
+
+    auto expected = compiled.search(state, 3, stack);
+    auto actual = runtime.search(state, 3, stack);
+    EXPECT_EQ(actual.first, expected.first);
+    EXPECT_EQ(actual.second, expected.second);
+}
+
+TEST(EngineTest, BlackFindsMateInOne) {
+    // Black to move: Ra8-a1 mates the white king behind its pawns.
+    Engine engine(":memory:");
+    ChessState state("r000000k000000pp0000000000000000000000000000000000000PPP000000K00111111");
+    SearchStack stack;
+
+    auto [move, score] = engine.search(state, 3, stack);
+    EXPECT_EQ(score, mateIn(1));
+    state.makeMove(move);
+    MoveList replies;
+    EXPECT_EQ(state.nodeStatus(replies), ChessState::CHECKMATE);
+}
+
+TEST(EngineTest, ScoresAreForSideToMove) {
+    // The starting position is symmetric, so it scores the same for either side to move.
+    Engine engine(":memory:");
+    SearchStack stack;
+    ChessState white("rnbqkbnrpppppppp00000000000000000000000000000000PPPPPPPPRNBQKBNR1000000");
+    ChessState black("rnbqkbnrpppppppp00000000000000000000000000000000PPPPPPPPRNBQKBNR0000000");
+    Score whiteScore = engine.search(white, 2, stack).second;
+    Score blackScore = engine.search(black, 2, stack).second;
+    EXPECT_FALSE(isMateScore(whiteScore));
+    EXPECT_EQ(whiteScore, blackScore);
+}
+
+TEST(EngineTest, LazyEvalSkipsLopsidedLeaves) {
+    // Position 4 of the perft suite, where black is a piece up.
+    const std::string lopsided = "r000k00rPppp0ppp0b000nbNnP000000BBP0P000q0000N00Pp0P00PPR00Q0RK01101100";
+    Engine lazy(":memory:"), exact(":memory:");
+    exact.setLazyMargin(SCORE_INFINITE);
+    ChessState state(lopsided);
+    SearchStack stack;
+
+    auto expected = exact.search(state, 4, stack);
+    auto actual = lazy.search(state, 4, stack);
+    EXPECT_EQ(actual.first, expected.first);
+    EXPECT_EQ(actual.second, expected.second);
+    EXPECT_EQ(exact.getEvalStats().lazyExits, 0u);
+    EXPECT_GT(lazy.getEvalStats().lazyExits, lazy.getEvalStats().evaluations / 2);
+}
+
+TEST(EngineTest, IterativeDeepeningReachesRequestedDepth) {
+    Engine engine(":memory:");
+    ChessState state(middlegame_state);
+    SearchStack stack;
+    SearchLimits limits;
+    limits.depth = 4;
+
+    engine.search(state, limits, stack);
+    EXPECT_EQ(stack.completedDepth, 4);
+    EXPECT_FALSE(stack.stopped);
+}
+
+TEST(EngineTest, SearchStopsAtNodeLimit) {
+    Engine engine(":memory:");
+    ChessState state(middlegame_state);
+    SearchStack stack;
+    SearchLimits limits;
+    limits.nodes = 20000;
+
+    auto [move, score] = engine.search(state, limits, stack);
+    EXPECT_TRUE(stack.stopped);
+    EXPECT_LE(stack.nodes, limits.nodes);
+    EXPECT_GE(stack.completedDepth, 1);
+    std::vector<ChessMove> legalMoves = state.getLegalMoves();
+    EXPECT_NE(std::find(legalMoves.begin(), legalMoves.end(), move), legalMoves.end());
+    EXPECT_EQ(state.toString(), middlegame_state);
+}
+
+TEST(EngineTest, SearchStopsAtDeadline) {
+    Engine engine(":memory:");
+    ChessState state(middlegame_state);
+    SearchStack stack;
+    SearchLimits limits;
+    limits.movetime = std::chrono::milliseconds(50);
+
+    auto start = std::chrono::steady_clock::now();
+    engine.search(state, limits, stack);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_TRUE(stack.stopped);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(250));
+    EXPECT_GE(stack.completedDepth, 1);
+    EXPECT_EQ(state.toString(), middlegame_state);
+}
+
+TEST(EngineTest, LazySmpSearchReachesRequestedDepth) {
+    Engine engine(":memory:");
+    engine.setThreads(4);
+    ChessState state(middlegame_state);
+    SearchStack stack;
+    SearchLimits limits;
+    limits.depth = 4;
+
+    auto [move, score] = engine.search(state, limits, stack);
+    EXPECT_EQ(engine.getThreads(), 4);
+    EXPECT_EQ(stack.completedDepth, 4);
+    EXPECT_EQ(state.toString(), middlegame_state);
+    std::vector<ChessMove> legalMoves = state.getLegalMoves();
+    EXPECT_NE(std::find(legalMoves.begin(), legalMoves.end(), move), legalMoves.end());
+    EXPECT_GT(engine.getEvalStats().evaluations, 0u);
+}
+
+TEST(EngineTest, LazySmpHelpersStopWithMainThread) {
+    Engine engine(":memory:");
+    engine.setThreads(4);
+    ChessState state(middlegame_state);
+    SearchStack stack;
+    SearchLimits limits;
+    limits.movetime = std::chrono::milliseconds(50);
+
+    auto start = std::chrono::steady_clock::now();
+    engine.search(state, limits, stack);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::milliseconds(250));
+    EXPECT_GE(stack.completedDepth, 1);
+    EXPECT_EQ(state.toString(), middlegame_state);
+}
+
+TEST(EngineTest, LazySmpHelpersDiverge) {
+    // The main thread searches every depth; no two helpers share a schedule.
+    std::vector<std::vector<bool>> schedules;
+    for (int thread = 0; thread < 16; thread++) {
+        std::vector<bool> schedule;
+        for (int depth = 1; depth <= 16; depth++)
+            schedule.push_back(Engine::searchesDepth(thread, depth));
+        EXPECT_EQ(std::find(schedules.begin(), schedules.end(), schedule), schedules.end()) << thread;
+        schedules.push_back(schedule);
+    }
+    EXPECT_EQ(schedules[0], std::vector<bool>(16, true));
+}
+
+TEST(EngineTest, ConcurrentSearchesKeepTheirMovetime) {
+    // Only one search gets the helpers; the other must not wait for it.
+    Engine engine(":memory:");
+    engine.setThreads(2);
+    SearchLimits limits;
+    limits.movetime = std::chrono::milliseconds(50);
+
+    auto start = std::chrono::steady_clock::now();
+    auto run = [&]() {
+        ChessState state(middlegame_state);
+        SearchStack stack;
+        engine.search(state, limits, stack);
+        EXPECT_GE(stack.completedDepth, 1);
+        EXPECT_EQ(state.toString(), middlegame_state);
+    };
+    std::thread other(run);
+    run();
+    other.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(250));
+}
+
+TEST(EngineTest, StoredMovesRespectTheRequestedBudget) {
+    Engine engine(":memory:");
+    auto evaluations = [&]() { return engine.getEvalStats().evaluations; };
+
+    engine.getBestMove(middlegame_state, 1);
+    uint64_t searched = evaluations();
+    engine.getBestMove(middlegame_state, 1);
+    EXPECT_EQ(evaluations(), searched);  // Served from the database
+
+    engine.getBestMove(middlegame_state, 3);
+    EXPECT_GT(evaluations(), searched);  // Stored search too shallow
+    searched = evaluations();
+    engine.getBestMove(middlegame_state, 2);
+    EXPECT_EQ(evaluations(), searched);
+
+    SearchLimits limits;
+    limits.depth = 3;
+    limits.movetime = std::chrono::milliseconds(20);
+    engine.getBestMove(middlegame_state, limits);
+    EXPECT_EQ(evaluations(), searched);
+
+    limits.depth = 0;
+    engine.getBestMove(middlegame_state, limits);
+    EXPECT_GT(evaluations(), searched);  // No depth limit to compare with
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "MovePicker.hpp"
+
+static const std::string pickerStates[] = {
+    "rnbqkbnrpppppppp00000000000000000000000000000000PPPPPPPPRNBQKBNR1000000",
+    "r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000",
+    "r000k00rPppp0ppp0b000nbNnP000000BBP0P000q0000N00Pp0P00PPR00Q0RK01101100",
+    "rnbq0k0rpp0Pbppp00p000000000000000B0000000000000PPP0NnPPRNBQK00R1010011",
+    "rnbqkbnrpppppppp0000000000000000000000000000q000PPPPPPPPRNBQKBNR1000000",
+};
+
+static std::vector<uint16_t> sortedKeys(const std::vector<ChessMove>& moves)
+{
+    std::vector<uint16_t> keys;
+    for (const ChessMove& move : moves)
+        keys.push_back(move.raw() & 0x3FFF);
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+TEST(MovePickerTest, ProducesExactlyTheLegalMoves) {
+    for (const std::string& stateStr : pickerStates) {
+        ChessState state(stateStr);
+        MoveList storage;
+        MovePicker picker(state, storage);
+        std::vector<ChessMove> picked;
+        ChessMove move;
+        while (picker.next(move))
+            picked.push_back(move);
+        EXPECT_EQ(sortedKeys(picked), sortedKeys(state.getLegalMoves())) << stateStr;
+    }
+}
+
+TEST(MovePickerTest, HashMoveFirstAndNotRepeated) {
+    ChessState state(pickerStates[1]);
+    ChessMove hashMove(7, 4, 7, 6, 0); // Castling
+    MoveList storage;
+    MovePicker picker(state, storage, hashMove);
+    ChessMove move;
+    ASSERT_TRUE(picker.next(move));
+    EXPECT_EQ(move, hashMove);
+    int count = 1;
+    while (picker.next(move)) {
+        EXPECT_NE(move, hashMove);
+        count++;
+    }
+    EXPECT_EQ(count, 48);
+}
+
+TEST(MovePickerTest, IllegalHashMoveIsSkipped) {
+    ChessState state(pickerStates[0]);
+    MoveList storage;
+    MovePicker picker(state, storage, ChessMove(6, 4, 3, 4, 0)); // Pawn cannot move three squares
+    ChessMove move;
+    int count = 0;
+    while (picker.next(move)) {
+        EXPECT_NE(move, ChessMove(6, 4, 3, 4, 0));
+        count++;
+    }
+    EXPECT_EQ(count, 20);
+}
+
+TEST(MovePickerTest, CapturesComeBeforeQuietMoves) {
+    ChessState state(pickerStates[1]);
+    MoveList storage;
+    MovePicker picker(state, storage);
+    ChessMove move;
+    bool seenQuiet = false;
+    while (picker.next(move)) {
+        bool capture = state.getPieceAt(move.getTo().first, move.getTo().second) != '0';
+        if (!capture)
+            seenQuiet = true;
+        else
+            EXPECT_FALSE(seenQuiet) << move.toString();
+    }
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include "Heuristic.hpp"
+
+static const std::string kiwipete = "r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000";
+
+// Writes a network with random weights in the PFNN format and returns its path.
+static std::string writeRandomNetwork(const std::string& name, uint32_t hidden = NNUE::HIDDEN) {
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> feature(-48, 48), bias(0, 96), output(-127, 127);
+
+    std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream file(path, std::ios::binary);
+    uint32_t version = 1;
+    file.write("PFNN", 4);
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char*>(&hidden), sizeof(hidden));
+    for (int i = 0; i < NNUE::INPUTS * NNUE::HIDDEN; i++) {
+        int16_t weight = static_cast<int16_t>(feature(rng));
+        file.write(reinterpret_cast<const char*>(&weight), sizeof(weight));
+    }
+    for (int i = 0; i < NNUE::HIDDEN; i++) {
+        int16_t weight = static_cast<int16_t>(bias(rng));
+        file.write(reinterpret_cast<const char*>(&weight), sizeof(weight));
+    }
+    for (int i = 0; i < 2 * NNUE::HIDDEN; i++) {
+        int8_t weight = static_cast<int8_t>(output(rng));
+        file.write(reinterpret_cast<const char*>(&weight), sizeof(weight));
+    }
+    int32_t outputBias = 1000;
+    file.write(reinterpret_cast<const char*>(&outputBias), sizeof(outputBias));
+    return path;
+}
+
+// Same position with the colors swapped and the board mirrored vertically.
+static std::string mirrored(const std::string& state) {
+    std::string result(71, '0');
+    for (int square = 0; square < 64; square++) {
+        char piece = state[square ^ 56];
+        result[square] = std::isupper(piece) ? std::tolower(piece) : std::toupper(piece);
+    }
+    result[64] = state[64] == '1' ? '0' : '1';
+    result[65] = state[66];
+    result[66] = state[65];
+    result[67] = state[69];
+    result[68] = state[70];
+    result[69] = state[67];
+    result[70] = state[68];
+    return result;
+}
+
+class NNUETest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto loaded = std::make_shared<NNUE::Network>();
+        ASSERT_TRUE(loaded->load(writeRandomNetwork("perchfish_nnue_test.nnue")));
+        network = loaded;
+    }
+
+    std::shared_ptr<const NNUE::Network> network;
+};
+
+TEST_F(NNUETest, RejectsMissingOrMalformedFiles) {
+    auto other = std::make_unique<NNUE::Network>();
+    EXPECT_FALSE(other->load("does_not_exist.nnue"));
+    EXPECT_FALSE(other->load(writeRandomNetwork("perchfish_nnue_wrong_size.nnue", NNUE::HIDDEN / 2)));
+}
+
+static void checkAccumulatorBelow(ChessState& state, const NNUE::Network& network, int depth) {
+    if (depth == 0)
+        return;
+    for (const ChessMove& move : state.getLegalMoves()) {
+        state.makeMove(move);
+        NNUE::Accumulator fresh;
+        network.refresh(fresh, state.pieces);
+        ASSERT_EQ(std::memcmp(&fresh, &state.accumulator, sizeof(fresh)), 0) << move.toString();
+        checkAccumulatorBelow(state, network, depth - 1);
+        state.unmakeMove(move);
+    }
+}
+
+TEST_F(NNUETest, IncrementalAccumulatorMatchesRefresh) {
+    ChessState state(kiwipete);
+    state.attachNetwork(network);
+    checkAccumulatorBelow(state, *network, 3);
+}
+
+TEST_F(NNUETest, EvaluateMatchesReferenceComputation) {
+    ChessState state(kiwipete);
+    state.attachNetwork(network);
+
+    // Straightforward recomputation of the whole network from the board.
+    int64_t output = network->outputBias;
+    // White is to move, so the white perspective comes first in the output layer.
+    for (int perspective = 0; perspective < 2; perspective++) {
+        for (int neuron = 0; neuron < NNUE::HIDDEN; neuron++) {
+            int32_t sum = network->featureBiases[neuron];
+            for (int piece = 0; piece < 12; piece++)
+                for (Bitboard bb = state.pieces[piece]; bb; )
+                    sum += network->featureWeights[NNUE::featureIndex(perspective, piece, popLsb(bb))][neuron];
+            int32_t activation = std::clamp(sum, 0, NNUE::QA);
+            output += activation * network->outputWeights[perspective * NNUE::HIDDEN + neuron];
+        }
+    }
+    int expected = static_cast<int>(output * NNUE::SCALE / (NNUE::QA * NNUE::QB));
+    EXPECT_EQ(network->evaluate(state.accumulator, state.whiteToMove), expected);
+}
+
+TEST_F(NNUETest, AttachedStateKeepsTheNetworkAlive) {
+    ChessState state(kiwipete);
+    {
+        NNUEHeuristic heuristic(network);
+        heuristic(state);
+    }
+    std::weak_ptr<const NNUE::Network> weak = network;
+    network.reset();
+    EXPECT_FALSE(weak.expired());
+
+    // The accumulator update after the heuristic is gone still has its network.
+    ChessMove move = state.getLegalMoves().front();
+    state.makeMove(move);
+    state.unmakeMove(move);
+}
+
+TEST_F(NNUETest, MirroredPositionScoresTheSameForTheSideToMove) {
+    NNUEHeuristic heuristic(network);
+    ChessState state(kiwipete);
+    ChessState flipped(mirrored(kiwipete));
+    // Heuristics score for white, so the mirrored position scores the opposite.
+    EXPECT_EQ(heuristic(state), -heuristic(flipped));
+    EXPECT_NE(heuristic(state), 0);
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "Engine.hpp"
+#include "PawnTable.hpp"
+
+static void checkPawnKeysBelow(ChessState& state, int depth) {
+    if (depth == 0)
+        return;
+    for (const ChessMove& move : state.getLegalMoves()) {
+        state.makeMove(move);
+        ASSERT_EQ(state.getPawnKey(), state.computePawnKey()) << move.toString();
+        checkPawnKeysBelow(state, depth - 1);
+        state.unmakeMove(move);
+    }
+}
+
+TEST(PawnTableTest, IncrementalPawnKeyMatchesComputed) {
+    // Kiwipete has pawn captures, en passant and double pushes within three plies.
+    ChessState state("r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000");
+    EXPECT_EQ(state.getPawnKey(), state.computePawnKey());
+    checkPawnKeysBelow(state, 3);
+}
+
+TEST(PawnTableTest, ScoresDoubledIsolatedAndPassedPawns) {
+    // White pawns on a2 and a3 are doubled and isolated; the black b7 pawn is isolated
+    // and stops either white pawn from being passed.
+    Bitboard white = squareBit(squareOf(6, 0)) | squareBit(squareOf(5, 0));
+    Bitboard black = squareBit(squareOf(1, 1));
+    PawnTable::Entry entry = PawnTable::evaluate(white, black);
+    EXPECT_EQ(entry.mg, (-10 - 2 * 10) - (-10));
+    EXPECT_EQ(entry.eg, (-20 - 2 * 15) - (-15));
+
+    // Without the black pawn both white pawns are passed (a2 on rank 1, a3 on rank 2).
+    entry = PawnTable::evaluate(white, 0);
+    EXPECT_EQ(entry.mg, -10 - 2 * 10 + 5 + 10);
+    EXPECT_EQ(entry.eg, -20 - 2 * 15 + 10 + 20);
+
+    // Mirrored structures score the opposite.
+    PawnTable::Entry mirrored = PawnTable::evaluate(0, squareBit(squareOf(1, 0)) | squareBit(squareOf(2, 0)));
+    EXPECT_EQ(mirrored.mg, -entry.mg);
+    EXPECT_EQ(mirrored.eg, -entry.eg);
+}
+
+TEST(PawnTableTest, MiddlegameSearchesHitTheCache) {
+    // Perft middlegame positions at the server's default depth, with the
+    // transposition table on as in real searches. The opening position falls short
+    // of this rate (see PawnTable.hpp).
+    const std::string middlegames[] = {
+        "r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000",
+        "rnbq0k0rpp0Pbppp00p000000000000000B0000000000000PPP0NnPPRNBQK00R1010011",
+        "r0000rk00pp0qpppp0np0n0000b0p0B000B0P0b0P0NP0N000PP0QPPPR0000RK01111111",
+    };
+    PawnTable& table = PawnTable::forThread();
+    uint64_t probes = 0, hits = 0;
+    for (const std::string& position : middlegames) {
+        table.clear();
+        Engine engine(":memory:");
+        ChessState state(position);
+        auto stack = std::make_unique<SearchStack>();
+        engine.search(state, 5, *stack);
+        probes += table.probes;
+        hits += table.hits;
+    }
+    ASSERT_GT(probes, 0u);
+    EXPECT_GT(static_cast<double>(hits) / probes, 0.95);
+}
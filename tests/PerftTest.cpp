@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "Perft.hpp"
+
+// Standard perft reference positions, converted to the 71-character state format.
+struct PerftCase
+{
+    const char* name;
+    const char* state;
+    int depth;
+    uint64_t nodes;
+};
+
+static const PerftCase perftCases[] = {
+    { "StartPosition", "rnbqkbnrpppppppp00000000000000000000000000000000PPPPPPPPRNBQKBNR1000000", 4, 197281 },
+    { "Kiwipete",      "r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000", 3, 97862 },
+    { "Position3",     "0000000000p00000000p0000KP00000r0R000p0k000000000000P0P0000000001111111", 4, 43238 },
+    { "Position4",     "r000k00rPppp0ppp0b000nbNnP000000BBP0P000q0000N00Pp0P00PPR00Q0RK01101100", 3, 9467 },
+    { "Position5",     "rnbq0k0rpp0Pbppp00p000000000000000B0000000000000PPP0NnPPRNBQK00R1010011", 3, 62379 },
+    { "Position6",     "r0000rk00pp0qpppp0np0n0000b0p0B000B0P0b0P0NP0N000PP0QPPPR0000RK01111111", 3, 89890 },
+    { "Castling",      "r000k00r000000000000000000000000000000000000000000000000R000K00R1000000", 3, 13744 },
+};
+
+class PerftTest : public ::testing::TestWithParam<PerftCase> {};
+
+TEST_P(PerftTest, MatchesReferenceNodeCount) {
+    const PerftCase& test = GetParam();
+    ChessState state(test.state);
+    EXPECT_EQ(state.perft(test.depth), test.nodes);
+    EXPECT_EQ(state.toString(), test.state);
+}
+
+TEST_P(PerftTest, HashedAndThreadedMatchPlain) {
+    const PerftCase& test = GetParam();
+    ChessState state(test.state);
+    PerftOptions options;
+    options.threads = 4;
+    options.hashMB = 16;
+    EXPECT_EQ(runPerft(state, test.depth, options).nodes, test.nodes);
+}
+
+INSTANTIATE_TEST_SUITE_P(ReferencePositions, PerftTest, ::testing::ValuesIn(perftCases),
+    [](const ::testing::TestParamInfo<PerftCase>& info) { return std::string(info.param.name); });
+
+TEST(PerftDivideTest, DivideSumsToTotal) {
+    ChessState state("rnbqkbnrpppppppp00000000000000000000000000000000PPPPPPPPRNBQKBNR1000000");
+    PerftOptions options;
+    options.divide = true;
+    PerftResult result = runPerft(state, 3, options);
+    ASSERT_EQ(result.divide.size(), 20u);
+    uint64_t total = 0;
+    for (const auto& [move, nodes] : result.divide)
+        total += nodes;
+    EXPECT_EQ(total, 8902u);
+    EXPECT_EQ(result.nodes, 8902u);
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include "Heuristic.hpp"
+#include "PieceSquare.hpp"
+
+static void expectSameScores(const PieceSquare::Scores& a, const PieceSquare::Scores& b, const std::string& state) {
+    EXPECT_EQ(a.mg, b.mg) << state;
+    EXPECT_EQ(a.eg, b.eg) << state;
+    EXPECT_EQ(a.phase, b.phase) << state;
+}
+
+// Checks every position below the given one against the scalar reference, the
+// incremental sums in ChessState and the material + PST part of Heuristic2.
+static void checkPositionsBelow(ChessState& state, int depth) {
+    const char* board = &state.state[0][0];
+    PieceSquare::Scores scores = PieceSquare::evaluate(board);
+    expectSameScores(scores, PieceSquare::evaluateScalar(board), state.toString());
+    expectSameScores(scores, {state.mgScore, state.egScore, state.phase}, state.toString());
+
+    Heuristic2 heuristic;
+    Score mobility = EvalTables::mobilityWeight * (state.mobility(WHITE) - state.mobility(BLACK));
+    PawnTable::Entry pawns = PawnTable::evaluate(state.pieces[WHITE_PAWN], state.pieces[BLACK_PAWN]);
+    Score pawnStructure = PieceSquare::interpolate({pawns.mg, pawns.eg, state.phase});
+    EXPECT_EQ(PieceSquare::interpolate(scores), heuristic(state) - mobility - pawnStructure)
+        << state.toString();
+
+    if (depth == 0)
+        return;
+    for (const ChessMove& move : state.getLegalMoves()) {
+        state.makeMove(move);
+        checkPositionsBelow(state, depth - 1);
+        state.unmakeMove(move);
+    }
+}
+
+TEST(PieceSquareTest, VectorizedMatchesScalarAndIncremental) {
+    const char* states[] = {
+        "rnbqkbnrpppppppp00000000000000000000000000000000PPPPPPPPRNBQKBNR1000000",
+        "r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000",
+        "r000k00rPppp0ppp0b000nbNnP000000BBP0P000q0000N00Pp0P00PPR00Q0RK01101100",
+        "0000000000p00000000p0000KP00000r0R000p0k000000000000P0P0000000001111111",
+    };
+    for (const char* stateStr : states) {
+        ChessState state(stateStr);
+        checkPositionsBelow(state, 2);
+    }
+}
+
+TEST(PieceSquareTest, StartPositionIsBalanced) {
+    ChessState state("rnbqkbnrpppppppp00000000000000000000000000000000PPPPPPPPRNBQKBNR1000000");
+    PieceSquare::Scores scores = PieceSquare::evaluate(&state.state[0][0]);
+    EXPECT_EQ(scores.mg, 0);
+    EXPECT_EQ(scores.eg, 0);
+    EXPECT_EQ(scores.phase, EvalTables::MAX_PHASE);
+}
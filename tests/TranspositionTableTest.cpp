@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "Engine.hpp"
+#include "TranspositionTable.hpp"
+
+TEST(TranspositionTableTest, StoresAndProbesEntries) {
+    TranspositionTable table(1);
+    TranspositionTable::Entry entry;
+    EXPECT_FALSE(table.probe(0x1234, entry));
+
+    ChessMove move = ChessMove::fromSquares(52, 36, ChessMove::NORMAL);
+    table.store(0x1234, { move, -250, 7, TranspositionTable::LOWER_BOUND });
+    ASSERT_TRUE(table.probe(0x1234, entry));
+    EXPECT_EQ(entry.move, move);
+    EXPECT_EQ(entry.score, -250);
+    EXPECT_EQ(entry.depth, 7);
+    EXPECT_EQ(entry.bound, TranspositionTable::LOWER_BOUND);
+    EXPECT_EQ(table.hits(), 1u);
+    EXPECT_EQ(table.probes(), 2u);
+
+    table.clear();
+    EXPECT_FALSE(table.probe(0x1234, entry));
+}
+
+TEST(TranspositionTableTest, DeepEntriesSurviveShallowStores) {
+    TranspositionTable table(1);
+    uint64_t stride = table.bucketCount();  // Keys that share a bucket
+    uint64_t deep = 5, shallow = deep + stride, other = deep + 2 * stride;
+
+    table.store(deep, { ChessMove(), 10, 8, TranspositionTable::EXACT });
+    table.store(shallow, { ChessMove(), 20, 2, TranspositionTable::EXACT });
+    TranspositionTable::Entry entry;
+    EXPECT_TRUE(table.probe(deep, entry));
+    EXPECT_TRUE(table.probe(shallow, entry));
+
+    // The always-replace slot takes the next shallow store; the deep entry stays.
+    table.store(other, { ChessMove(), 30, 3, TranspositionTable::EXACT });
+    EXPECT_TRUE(table.probe(deep, entry));
+    EXPECT_FALSE(table.probe(shallow, entry));
+    EXPECT_TRUE(table.probe(other, entry));
+    EXPECT_EQ(table.collisions(), 1u);
+
+    // A deeper search replaces the depth-preferred slot.
+    table.store(shallow, { ChessMove(), 40, 9, TranspositionTable::EXACT });
+    ASSERT_TRUE(table.probe(shallow, entry));
+    EXPECT_EQ(entry.score, 40);
+    EXPECT_FALSE(table.probe(deep, entry));
+}
+
+TEST(TranspositionTableTest, MateScoresAreStoredRelativeToTheNode) {
+    // Mated 3 plies below a node at ply 4 is matedIn(7) from the root; from another
+    // path reaching the node at ply 2 it is matedIn(5).
+    Score stored = TranspositionTable::toStored(matedIn(7), 4);
+    EXPECT_EQ(TranspositionTable::fromStored(stored, 2), matedIn(5));
+    EXPECT_EQ(TranspositionTable::fromStored(TranspositionTable::toStored(mateIn(9), 6), 6), mateIn(9));
+    EXPECT_EQ(TranspositionTable::toStored(150, 6), 150);
+}
+
+TEST(TranspositionTableTest, SearchReusesTranspositions) {
+    const std::string middlegame = "r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000";
+    Engine hashed(":memory:", 16), unhashed(":memory:", 0);
+    ChessState state(middlegame);
+    SearchStack stack;
+
+    auto expected = unhashed.search(state, 5, stack);
+    uint64_t unhashedNodes = stack.nodes;
+    auto [move, score] = hashed.search(state, 5, stack);
+    uint64_t hashedNodes = stack.nodes;
+    const TranspositionTable& table = hashed.getTranspositionTable();
+    EXPECT_LT(hashedNodes, unhashedNodes);
+    EXPECT_GT(table.cutoffs(), 0u);
+    EXPECT_EQ(score, expected.second);
+
+    // Searching the same position again is answered below the root.
+    hashed.search(state, 5, stack);
+    EXPECT_LT(stack.nodes, hashedNodes / 10);
+
+    // The root result is stored for the next search.
+    TranspositionTable::Entry entry;
+    ASSERT_TRUE(table.probe(state.getKey(), entry));
+    EXPECT_EQ(entry.move, move);
+    EXPECT_EQ(entry.score, score);
+    EXPECT_EQ(entry.depth, 5);
+}
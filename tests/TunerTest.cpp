@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "Heuristic.hpp"
+#include "Tuner.hpp"
+
+const std::string kiwipete = "r000k00rp0ppqpb0bn00pnp0000PN0000p00P00000N00Q0pPPPBBPPPR000K00R1000000";
+
+static void collectPositions(ChessState& state, int depth, std::vector<ChessState>& states) {
+    states.push_back(state);
+    if (depth == 0)
+        return;
+    for (const ChessMove& move : state.getLegalMoves()) {
+        state.makeMove(move);
+        collectPositions(state, depth - 1, states);
+        state.unmakeMove(move);
+    }
+}
+
+TEST(TunerTest, FeaturesReproduceHeuristic2) {
+    ChessState root(kiwipete);
+    std::vector<ChessState> states;
+    collectPositions(root, 2, states);
+
+    Tuner::Parameters parameters = Tuner::defaultParameters();
+    Heuristic2 heuristic;
+    for (ChessState& state : states) {
+        // Heuristic2 rounds its two phase interpolations down; the tuner does not.
+        double tuned = Tuner::evaluate(parameters, Tuner::extract(state, 0.5f));
+        EXPECT_NEAR(tuned, heuristic(state), 2.0) << state.toString();
+    }
+}
+
+TEST(TunerTest, ParsesStateAndFenLines) {
+    const std::string start = "rnbqkbnrpppppppp00000000000000000000000000000000PPPPPPPPRNBQKBNR1000000";
+    Tuner::Position fromState, fromFen, fromEpd;
+    ASSERT_TRUE(Tuner::parseLine(start + " 1/2-1/2", fromState));
+    ASSERT_TRUE(Tuner::parseLine("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 [0.5]", fromFen));
+    ASSERT_TRUE(Tuner::parseLine("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - c9 \"0-1\";", fromEpd));
+    EXPECT_EQ(fromState.result, 0.5f);
+    EXPECT_EQ(fromFen.result, 0.5f);
+    EXPECT_EQ(fromEpd.result, 0.0f);
+    EXPECT_EQ(std::memcmp(fromState.squares, fromFen.squares, sizeof(fromState.squares)), 0);
+    EXPECT_EQ(fromState.mobility, fromFen.mobility);
+
+    Tuner::Position position;
+    EXPECT_FALSE(Tuner::parseLine(start, position));  // No result
+    EXPECT_FALSE(Tuner::parseLine("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", position));
+    EXPECT_FALSE(Tuner::parseLine("not a position 1-0", position));
+}
+
+TEST(TunerTest, LoadsFileAcrossThreads) {
+    std::string path = testing::TempDir() + "perchfish_tuner_positions.txt";
+    {
+        std::ofstream out(path);
+        for (int i = 0; i < 100; i++)
+            out << kiwipete << (i % 2 ? " 1-0\n" : " 0.5\n");
+        out << "garbage\n\n";
+    }
+
+    size_t skipped = 0;
+    std::vector<Tuner::Position> positions = Tuner::loadPositions(path, 4, skipped);
+    std::remove(path.c_str());
+    EXPECT_EQ(positions.size(), 100u);
+    EXPECT_EQ(skipped, 1u);
+}
+
+TEST(TunerTest, TuningFitsLabelledPositions) {
+    // Label positions with the results a stronger knight would predict, then tune
+    // from the current weights towards them.
+    ChessState root(kiwipete);
+    std::vector<ChessState> states;
+    collectPositions(root, 2, states);
+
+    Tuner::Parameters target = Tuner::defaultParameters();
+    target[Tuner::MG_VALUE + KNIGHT] += 150;
+    target[Tuner::EG_VALUE + KNIGHT] += 150;
+    std::vector<Tuner::Position> positions;
+    for (ChessState& state : states) {
+        Tuner::Position position = Tuner::extract(state, 0.0f);
+        position.result = static_cast<float>(1.0 / (1.0 + std::pow(10.0, -Tuner::evaluate(target, position) / 400.0)));
+        positions.push_back(position);
+    }
+
+    Tuner::Parameters parameters = Tuner::defaultParameters();
+    Tuner::Options options;
+    options.threads = 4;
+    options.iterations = 200;
+    options.reportEvery = 0;
+    double before = Tuner::error(parameters, positions, 1.0, options.threads);
+    double after = Tuner::tune(parameters, positions, 1.0, options);
+    EXPECT_LT(after, before / 2);
+    EXPECT_GT(parameters[Tuner::MG_VALUE + KNIGHT], Tuner::defaultParameters()[Tuner::MG_VALUE + KNIGHT]);
+
+    std::ostringstream header;
+    Tuner::writeHeader(parameters, header);
+    EXPECT_NE(header.str().find("namespace EvalTables"), std::string::npos);
+    EXPECT_NE(header.str().find("constexpr int mobilityWeight = "), std::string::npos);
+}